@@ -0,0 +1,13 @@
+# gera uma escada de 2 x 500000 vértices (dois caminhos a0 .. a499999 e b0 .. b499999
+# com os degraus ai -- bi), com peso 3, e uma cauda presa a a0; a busca em profundidade
+# dos cortes desce cerca de 1000000 níveis, o que estoura a pilha de uma versão recursiva
+BEGIN {
+  n = 500000
+  print "cadeia_longa"
+  for (i = 0; i < n; i++) {
+    printf "a%d -- b%d 3\n", i, i
+    if (i + 1 < n)
+      printf "a%d -- a%d 3\nb%d -- b%d 3\n", i, i + 1, i, i + 1
+  }
+  print "a0 -- cauda 3"
+}
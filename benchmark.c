@@ -0,0 +1,594 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "grafo.h"
+
+//------------------------------------------------------------------------------
+// mede o tempo de cada função de grafo.h sobre grafos sintéticos
+//
+// uso: ./benchmark [num_vertices] [num_threads] [familia]
+//
+// para cada família de grafos (ou só a pedida), gera um grafo com cerca de
+// num_vertices vértices no formato de le_grafo e mede cada função sobre uma
+// cópia nova do grafo, carregada de uma imagem binária temporária, para que nenhum resultado
+// guardado de uma medição aproveite a outra
+//
+// cada medição é uma linha JSON em stdout com a família, o tamanho do grafo,
+// a função, o tempo em segundos, as arestas por segundo e o pico de memória
+// residente do processo (em KiB) durante a medição
+//
+// para reordena_vertices, o grafo é relido com as arestas e os nomes dos vértices
+// embaralhados e, para cada ordem (e sem renumeração), são medidos o
+// tempo e as falhas de cache (contador de hardware do Linux, ou null se o sistema
+// não o oferece) de n_componentes e vertices_corte
+
+//------------------------------------------------------------------------------
+// caminho da imagem binária usada pelas medições, criada por mkstemp em $TMPDIR
+// (ou /tmp) e removida na saída, por exit ou por SIGINT, SIGTERM, SIGHUP ou SIGPIPE
+static char imagem_benchmark[4096];
+
+static void remove_imagem(void) {
+
+  if (imagem_benchmark[0])
+    unlink(imagem_benchmark);
+}
+
+static void sai_por_sinal(int sinal) {
+
+  // unlink e _exit podem ser chamadas de um tratador de sinal
+  if (imagem_benchmark[0])
+    unlink(imagem_benchmark);
+  _exit(128 + sinal);
+}
+
+static void cria_imagem(void) {
+  const char *diretorio = getenv("TMPDIR");
+
+  if (!diretorio || !diretorio[0])
+    diretorio = "/tmp";
+
+  int n = snprintf(imagem_benchmark, sizeof(imagem_benchmark), "%s/benchmark.grafo.XXXXXX", diretorio);
+  int fd = ((n > 0) && ((size_t) n < sizeof(imagem_benchmark))) ? mkstemp(imagem_benchmark) : -1;
+
+  if (fd < 0) {
+    imagem_benchmark[0] = '\0';
+    fprintf(stderr, "benchmark: erro ao criar a imagem binária em %s\n", diretorio);
+    exit(1);
+  }
+  close(fd);
+
+  atexit(remove_imagem);
+  signal(SIGINT, sai_por_sinal);
+  signal(SIGTERM, sai_por_sinal);
+  signal(SIGHUP, sai_por_sinal);
+  signal(SIGPIPE, sai_por_sinal);
+}
+
+//------------------------------------------------------------------------------
+// arestas geradas, com identificadores inteiros dos vértices
+typedef struct {
+  uint32_t *u;
+  uint32_t *v;
+  uint32_t *w;
+  size_t tamanho;
+  size_t capacidade;
+  uint32_t num_vertices;
+} arestas_geradas;
+
+//------------------------------------------------------------------------------
+// gerador xorshift64*, para que os grafos sejam os mesmos a cada execução
+static uint64_t estado_aleatorio = 88172645463325252ull;
+
+static uint32_t aleatorio(uint32_t limite) {
+
+  estado_aleatorio ^= estado_aleatorio >> 12;
+  estado_aleatorio ^= estado_aleatorio << 25;
+  estado_aleatorio ^= estado_aleatorio >> 27;
+
+  return (uint32_t) ((estado_aleatorio * 2685821657736338717ull) >> 32) % limite;
+}
+
+//------------------------------------------------------------------------------
+static void adiciona(arestas_geradas *a, uint32_t u, uint32_t v, uint32_t w) {
+
+  if (a->tamanho == a->capacidade) {
+    a->capacidade = a->capacidade ? 2 * a->capacidade : 1024;
+    a->u = realloc(a->u, sizeof(uint32_t) * a->capacidade);
+    a->v = realloc(a->v, sizeof(uint32_t) * a->capacidade);
+    a->w = realloc(a->w, sizeof(uint32_t) * a->capacidade);
+
+    if (!a->u || !a->v || !a->w) {
+      fprintf(stderr, "benchmark: erro em realloc\n");
+      exit(1);
+    }
+  }
+
+  a->u[a->tamanho] = u;
+  a->v[a->tamanho] = v;
+  a->w[a->tamanho] = w;
+  a->tamanho++;
+}
+
+//------------------------------------------------------------------------------
+// caminho com n vértices e pesos 1
+static void gera_caminho(arestas_geradas *a, uint32_t n) {
+
+  a->num_vertices = n;
+  for (uint32_t i = 1; i < n; i++)
+    adiciona(a, i - 1, i, 1);
+}
+
+//------------------------------------------------------------------------------
+// grade quadrada com cerca de n vértices e pesos 1
+static void gera_grade(arestas_geradas *a, uint32_t n) {
+  uint32_t lado = 1;
+
+  while ((lado + 1) * (lado + 1) <= n)
+    lado++;
+
+  a->num_vertices = lado * lado;
+  for (uint32_t i = 0; i < lado; i++) {
+    for (uint32_t j = 0; j < lado; j++) {
+      if (j + 1 < lado)
+        adiciona(a, i * lado + j, i * lado + j + 1, 1);
+      if (i + 1 < lado)
+        adiciona(a, i * lado + j, (i + 1) * lado + j, 1);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// árvore aleatória (cada vértice se liga a um anterior) com pesos até 10^6
+static void gera_arvore(arestas_geradas *a, uint32_t n) {
+
+  a->num_vertices = n;
+  for (uint32_t i = 1; i < n; i++)
+    adiciona(a, aleatorio(i), i, 1 + aleatorio(1000000));
+}
+
+//------------------------------------------------------------------------------
+// Erdős–Rényi com 4n arestas e pesos até 100
+static void gera_erdos_renyi(arestas_geradas *a, uint32_t n) {
+
+  a->num_vertices = n;
+  for (uint32_t i = 0; i < 4 * n; i++)
+    adiciona(a, aleatorio(n), aleatorio(n), 1 + aleatorio(100));
+}
+
+//------------------------------------------------------------------------------
+// Barabási–Albert (ligação preferencial, 3 arestas por vértice novo) com pesos 1
+//
+// sorteia uma ponta de uma aresta já existente, o que escolhe cada vértice com
+// probabilidade proporcional ao grau
+static void gera_barabasi_albert(arestas_geradas *a, uint32_t n) {
+
+  a->num_vertices = n;
+  adiciona(a, 0, 1, 1);
+  for (uint32_t i = 2; i < n; i++) {
+    size_t existentes = a->tamanho;
+
+    for (uint32_t k = 0; k < 3; k++) {
+      uint32_t sorteada = aleatorio((uint32_t) (2 * existentes));
+      uint32_t destino = (sorteada % 2) ? a->v[sorteada / 2] : a->u[sorteada / 2];
+      adiciona(a, i, destino, 1);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// muitos componentes pequenos: ciclos de 3 a 10 vértices com pesos até 50
+static void gera_componentes(arestas_geradas *a, uint32_t n) {
+  uint32_t inicio = 0;
+
+  while (inicio + 3 <= n) {
+    uint32_t tamanho = 3 + aleatorio(8);
+
+    if (inicio + tamanho > n)
+      tamanho = n - inicio;
+
+    for (uint32_t i = 0; i < tamanho; i++)
+      adiciona(a, inicio + i, inicio + (i + 1) % tamanho, 1 + aleatorio(50));
+
+    inicio += tamanho;
+  }
+  a->num_vertices = inicio;
+}
+
+//------------------------------------------------------------------------------
+typedef struct {
+  const char *nome;
+  void (*gera)(arestas_geradas *a, uint32_t n);
+} familia;
+
+static const familia familias[] = {
+  { "caminho", gera_caminho },
+  { "grade", gera_grade },
+  { "arvore", gera_arvore },
+  { "erdos_renyi", gera_erdos_renyi },
+  { "barabasi_albert", gera_barabasi_albert },
+  { "componentes", gera_componentes },
+};
+
+//------------------------------------------------------------------------------
+// escreve as arestas em f no formato de le_grafo e volta ao início
+static void escreve_grafo(FILE *f, const char *nome_grafo, arestas_geradas *a) {
+
+  fprintf(f, "// grafo sintético gerado por benchmark\n%s\n", nome_grafo);
+  for (size_t i = 0; i < a->tamanho; i++)
+    fprintf(f, "%u -- %u %u\n", a->u[i], a->v[i], a->w[i]);
+
+  rewind(f);
+}
+
+//------------------------------------------------------------------------------
+static double agora(void) {
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+
+  return (double) t.tv_sec + (double) t.tv_nsec / 1e9;
+}
+
+//------------------------------------------------------------------------------
+// o pico de memória residente (VmHWM) volta à memória residente atual quando se
+// escreve 5 em /proc/self/clear_refs; sem isso (fora do Linux, por exemplo), o pico
+// relatado é o do processo inteiro, de ru_maxrss
+static void zera_pico_rss(void) {
+  FILE *f = fopen("/proc/self/clear_refs", "w");
+
+  if (f) {
+    fputs("5", f);
+    fclose(f);
+  }
+}
+
+static long pico_rss(void) {
+  FILE *f = fopen("/proc/self/status", "r");
+  char linha[256];
+  long pico = -1;
+
+  if (f) {
+    while (fgets(linha, sizeof(linha), f)) {
+      if (strncmp(linha, "VmHWM:", 6) == 0) {
+        pico = strtol(linha + 6, NULL, 10);
+        break;
+      }
+    }
+    fclose(f);
+  }
+
+  if (pico < 0) {
+    struct rusage uso;
+
+    if (getrusage(RUSAGE_SELF, &uso) == 0)
+      pico = uso.ru_maxrss;
+  }
+
+  return pico;
+}
+
+//------------------------------------------------------------------------------
+// início de uma medição: zera o pico de memória e devolve o instante atual
+static double inicia_medicao(void) {
+
+  zera_pico_rss();
+  return agora();
+}
+
+//------------------------------------------------------------------------------
+static void relata(const char *nome_familia, arestas_geradas *a, const char *funcao, double segundos) {
+
+  printf("{\"familia\": \"%s\", \"vertices\": %u, \"arestas\": %zu, \"funcao\": \"%s\", "
+         "\"segundos\": %.6f, \"arestas_por_segundo\": %.0f, \"pico_rss_kb\": %ld}\n",
+         nome_familia, a->num_vertices, a->tamanho, funcao, segundos,
+         segundos > 0 ? (double) a->tamanho / segundos : 0.0, pico_rss());
+  fflush(stdout);
+}
+
+//------------------------------------------------------------------------------
+// com a biblioteca compilada com -DGRAFO_STATS, imprime também os contadores de g
+static void relata_estatisticas(const char *nome_familia, const char *funcao, grafo *g) {
+  estatisticas_grafo e;
+
+  if (!grafo_estatisticas(g, &e)) {
+    return;
+  }
+
+  printf("{\"familia\": \"%s\", \"funcao\": \"%s\", \"vertices_visitados\": %" PRIu64 ", "
+         "\"arestas_examinadas\": %" PRIu64 ", \"execucoes_sssp\": %" PRIu64 ", "
+         "\"operacoes_fila\": %" PRIu64 ", \"bytes_alocados\": %" PRIu64 "}\n",
+         nome_familia, funcao, e.vertices_visitados, e.arestas_examinadas, e.execucoes_sssp,
+         e.operacoes_fila, e.bytes_alocados);
+  fflush(stdout);
+}
+
+//------------------------------------------------------------------------------
+// abre o contador de falhas de cache do processo (e das threads que ele criar)
+//
+// devolve -1 se o sistema não oferece o contador
+static int abre_contador_cache(void) {
+  struct perf_event_attr atributos;
+
+  memset(&atributos, 0, sizeof(atributos));
+  atributos.type = PERF_TYPE_HARDWARE;
+  atributos.size = sizeof(atributos);
+  atributos.config = PERF_COUNT_HW_CACHE_MISSES;
+  atributos.disabled = 1;
+  atributos.inherit = 1;
+  atributos.exclude_kernel = 1;
+  atributos.exclude_hv = 1;
+
+  return (int) syscall(SYS_perf_event_open, &atributos, 0, -1, -1, 0);
+}
+
+//------------------------------------------------------------------------------
+// mede uma consulta que devolve uma "string" (ou, se numero não é NULL, um número)
+// sobre g, já renumerado pela ordem dada
+static void mede_com_cache(const char *nome_familia, arestas_geradas *a, const char *ordem,
+                           const char *funcao, grafo *g, char *(*string)(grafo *),
+                           unsigned int (*numero)(grafo *)) {
+  int contador = abre_contador_cache();
+  uint64_t falhas = 0;
+
+  if (contador >= 0) {
+    ioctl(contador, PERF_EVENT_IOC_RESET, 0);
+    ioctl(contador, PERF_EVENT_IOC_ENABLE, 0);
+  }
+
+  double t = agora();
+  if (numero) {
+    volatile unsigned int resultado = numero(g);
+    (void) resultado;
+  } else {
+    free(string(g));
+  }
+  double segundos = agora() - t;
+
+  if (contador >= 0) {
+    ioctl(contador, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(contador, &falhas, sizeof(falhas)) != (ssize_t) sizeof(falhas))
+      contador = -1;
+    close(contador);
+  }
+
+  printf("{\"familia\": \"%s\", \"vertices\": %u, \"arestas\": %zu, \"funcao\": \"%s\", "
+         "\"ordem\": \"%s\", \"segundos\": %.6f, \"falhas_cache\": ",
+         nome_familia, a->num_vertices, a->tamanho, funcao, ordem, segundos);
+  if (contador >= 0)
+    printf("%" PRIu64 "}\n", falhas);
+  else
+    printf("null}\n");
+  fflush(stdout);
+}
+
+//------------------------------------------------------------------------------
+// embaralha os n valores de v com o gerador
+static void embaralha(uint32_t *v, uint32_t n) {
+
+  for (uint32_t i = 0; i < n; i++)
+    v[i] = i;
+
+  for (uint32_t i = n; i > 1; i--) {
+    uint32_t j = aleatorio(i);
+    uint32_t troca = v[i - 1];
+    v[i - 1] = v[j];
+    v[j] = troca;
+  }
+}
+
+//------------------------------------------------------------------------------
+// mede reordena_vertices e o efeito de cada ordem nas buscas
+//
+// o grafo é lido de um texto com as arestas em ordem aleatória e os nomes dos
+// vértices permutados, como numa entrada coletada sem ordem: os índices dos
+// vértices, dados pela ordem de aparição, ficam espalhados em relação à estrutura
+// do grafo e aos nomes. O embaralhamento usa o gerador e depois restaura seu
+// estado, para que as próximas famílias não mudem
+static void mede_reordenacao(const char *nome_familia, arestas_geradas *a, unsigned int num_threads) {
+  static const char *nomes_ordens[] = { "cuthill_mckee", "largura", "grau" };
+  uint64_t estado = estado_aleatorio;
+  uint32_t *nomes = malloc(sizeof(uint32_t) * (a->num_vertices ? a->num_vertices : 1));
+  uint32_t *ordem_arestas = malloc(sizeof(uint32_t) * (a->tamanho ? a->tamanho : 1));
+  FILE *f = tmpfile();
+
+  if (!nomes || !ordem_arestas || !f) {
+    fprintf(stderr, "benchmark: erro ao preparar a renumeração\n");
+    exit(1);
+  }
+
+  embaralha(nomes, a->num_vertices);
+  embaralha(ordem_arestas, (uint32_t) a->tamanho);
+  estado_aleatorio = estado;
+
+  fprintf(f, "%s\n", nome_familia);
+  for (size_t i = 0; i < a->tamanho; i++) {
+    uint32_t k = ordem_arestas[i];
+    fprintf(f, "%u -- %u %u\n", nomes[a->u[k]], nomes[a->v[k]], a->w[k]);
+  }
+
+  // ordem -1: sem renumeração
+  for (int ordem = -1; ordem < 3; ordem++) {
+    const char *nome_ordem = (ordem < 0) ? "embaralhada" : nomes_ordens[ordem];
+
+    for (int consulta = 0; consulta < 2; consulta++) {
+      rewind(f);
+      grafo *g = le_grafo(f);
+      define_num_threads(g, num_threads);
+
+      if (ordem >= 0) {
+        double t = inicia_medicao();
+        reordena_vertices(g, (ordem_vertices) ordem);
+        if (consulta == 0) {
+          char funcao[64];
+          snprintf(funcao, sizeof(funcao), "reordena_vertices_%s", nome_ordem);
+          relata(nome_familia, a, funcao, agora() - t);
+        }
+      }
+
+      if (consulta == 0)
+        mede_com_cache(nome_familia, a, nome_ordem, "n_componentes", g, NULL, n_componentes);
+      else
+        mede_com_cache(nome_familia, a, nome_ordem, "vertices_corte", g, vertices_corte, NULL);
+      destroi_grafo(g);
+    }
+  }
+
+  fclose(f);
+  free(nomes);
+  free(ordem_arestas);
+}
+
+//------------------------------------------------------------------------------
+// carrega uma cópia nova do grafo da imagem binária
+static grafo *copia_nova(unsigned int num_threads) {
+  grafo *g = carrega_grafo_binario(imagem_benchmark);
+
+  if (!g) {
+    fprintf(stderr, "benchmark: erro ao carregar %s\n", imagem_benchmark);
+    exit(1);
+  }
+  define_num_threads(g, num_threads);
+
+  return g;
+}
+
+//------------------------------------------------------------------------------
+// mede uma função que devolve uma "string"
+static void mede_string(const char *nome_familia, arestas_geradas *a, unsigned int num_threads,
+                        const char *funcao, char *(*f)(grafo *)) {
+  grafo *g = copia_nova(num_threads);
+  double t = inicia_medicao();
+  char *s = f(g);
+
+  relata(nome_familia, a, funcao, agora() - t);
+  relata_estatisticas(nome_familia, funcao, g);
+  free(s);
+  destroi_grafo(g);
+}
+
+//------------------------------------------------------------------------------
+// mede uma função que devolve um número
+static void mede_numero(const char *nome_familia, arestas_geradas *a, unsigned int num_threads,
+                        const char *funcao, unsigned int (*f)(grafo *)) {
+  grafo *g = copia_nova(num_threads);
+  double t = inicia_medicao();
+  volatile unsigned int resultado = f(g);
+
+  (void) resultado;
+  relata(nome_familia, a, funcao, agora() - t);
+  relata_estatisticas(nome_familia, funcao, g);
+  destroi_grafo(g);
+}
+
+//------------------------------------------------------------------------------
+static void mede_familia(const familia *fam, uint32_t num_vertices, unsigned int num_threads) {
+  arestas_geradas a;
+  double t;
+  grafo *g;
+
+  memset(&a, 0, sizeof(a));
+  fam->gera(&a, num_vertices);
+
+  FILE *f = tmpfile();
+  if (!f) {
+    fprintf(stderr, "benchmark: erro em tmpfile\n");
+    exit(1);
+  }
+  escreve_grafo(f, fam->nome, &a);
+
+  // leitura do texto, sequencial e paralela
+  t = inicia_medicao();
+  g = le_grafo(f);
+  relata(fam->nome, &a, "le_grafo", agora() - t);
+
+  t = inicia_medicao();
+  if (!salva_grafo_binario(g, imagem_benchmark)) {
+    fprintf(stderr, "benchmark: erro ao gravar %s\n", imagem_benchmark);
+    exit(1);
+  }
+  relata(fam->nome, &a, "salva_grafo_binario", agora() - t);
+
+  t = inicia_medicao();
+  destroi_grafo(g);
+  relata(fam->nome, &a, "destroi_grafo", agora() - t);
+
+  rewind(f);
+  t = inicia_medicao();
+  g = le_grafo_paralelo(f, num_threads);
+  relata(fam->nome, &a, "le_grafo_paralelo", agora() - t);
+  destroi_grafo(g);
+  fclose(f);
+
+  // construção direta da memória
+  t = inicia_medicao();
+  grafo_builder *b = grafo_builder_cria(fam->nome, a.num_vertices, a.tamanho);
+  builder_define_num_vertices(b, a.num_vertices);
+  builder_adiciona_arestas(b, a.u, a.v, a.w, a.tamanho);
+  g = builder_finaliza(b);
+  relata(fam->nome, &a, "builder_finaliza", agora() - t);
+  destroi_grafo(g);
+
+  // inserção aresta a aresta num grafo vazio
+  g = builder_finaliza(grafo_builder_cria(fam->nome, 0, 0));
+  t = inicia_medicao();
+  for (size_t i = 0; i < a.tamanho; i++) {
+    char nome_u[16], nome_v[16];
+
+    snprintf(nome_u, sizeof(nome_u), "%u", a.u[i]);
+    snprintf(nome_v, sizeof(nome_v), "%u", a.v[i]);
+    insere_aresta(g, nome_u, nome_v, a.w[i]);
+  }
+  relata(fam->nome, &a, "insere_aresta", agora() - t);
+  destroi_grafo(g);
+
+  t = inicia_medicao();
+  g = carrega_grafo_binario(imagem_benchmark);
+  relata(fam->nome, &a, "carrega_grafo_binario", agora() - t);
+  destroi_grafo(g);
+
+  // consultas, cada uma sobre uma cópia nova
+  mede_numero(fam->nome, &a, num_threads, "n_vertices", n_vertices);
+  mede_numero(fam->nome, &a, num_threads, "n_arestas", n_arestas);
+  mede_numero(fam->nome, &a, num_threads, "n_componentes", n_componentes);
+  mede_numero(fam->nome, &a, num_threads, "bipartido", bipartido);
+  mede_string(fam->nome, &a, num_threads, "diametros", diametros);
+  mede_string(fam->nome, &a, num_threads, "vertices_corte", vertices_corte);
+  mede_string(fam->nome, &a, num_threads, "arestas_corte", arestas_corte);
+  mede_reordenacao(fam->nome, &a, num_threads);
+
+  free(a.u);
+  free(a.v);
+  free(a.w);
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+  uint32_t num_vertices = (argc > 1) ? (uint32_t) strtoul(argv[1], NULL, 10) : 50000;
+  unsigned int num_threads = (argc > 2) ? (unsigned int) strtoul(argv[2], NULL, 10) : 1;
+  const char *so_familia = (argc > 3) ? argv[3] : NULL;
+
+  if (num_vertices < 3) {
+    fprintf(stderr, "uso: %s [num_vertices >= 3] [num_threads] [familia]\n", argv[0]);
+    return 1;
+  }
+
+  cria_imagem();
+  for (size_t i = 0; i < sizeof(familias) / sizeof(familias[0]); i++) {
+    if (!so_familia || strcmp(so_familia, familias[i].nome) == 0)
+      mede_familia(&familias[i], num_vertices, num_threads);
+  }
+
+  return 0;
+}
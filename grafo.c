@@ -1,852 +1,6146 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "grafo.h"
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
-
-#define MAX_LINHA 2047
-
-// como so e usado dentro da struct vertice, so guarda a outra ponta e o peso
+#include <stdint.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define TAMANHO_BLOCO_LEITURA (1 << 20)
+#define TAMANHO_MINIMO_PEDACO (1 << 16)
+#define BITS_FATIAS_NOMES 6
+#define NUM_FATIAS_NOMES (1 << BITS_FATIAS_NOMES)
+#define TAMANHO_BLOCO_ARENA (1 << 16)
+#define TAMANHO_MAXIMO_BLOCO_ARENA (1 << 24)
+#define MAGICA_BINARIO "GRAFOBIN"
+#define VERSAO_BINARIO 2
+#define SEMENTE_CHECKSUM 14695981039346656037ull
+#define MARCA_ENDIAN 0x01020304u
+#define CAPACIDADE_HASH_INICIAL 64
+#define MAXIMO_VERTICES_BUILDER (1u << 30)
+#define HASH_VAZIO UINT_MAX
+#define DISTANCIA_INFINITA UINT64_MAX
+#define PESO_MAXIMO_BALDES 255
+#define BALDE_VAZIO UINT_MAX
+#define MINIMO_VERTICES_COMPONENTES_PARALELAS (1u << 14)
+#define RODADAS_AFFOREST 2
+#define AMOSTRAS_AFFOREST 1024
+#define NAO_VISITADO UINT_MAX
+#define ALFA_BUSCA 14
+#define BETA_BUSCA 24
+#define MINIMO_PASSO_PARALELO (1u << 14)
+#define MINIMO_VERTICES_CORTES_PARALELOS (1u << 14)
+#define MAXIMO_AUXILIARES (1u << 8)
+#define MINIMO_VERTICES_LIMITANTES_PARALELOS (1u << 14)
+
+// Largura, em palavras de 64 bits, dos conjuntos de origens da busca em largura com varias origens
+// (uma operacao vetorial por palavra de 256 bits com AVX2, de 128 com SSE2)
+#if defined(__AVX2__)
+#define PALAVRAS_MULTIPLA 4
+#elif defined(__SSE2__)
+#define PALAVRAS_MULTIPLA 2
+#else
+#define PALAVRAS_MULTIPLA 1
+#endif
+#define ORIGENS_MULTIPLA (64 * PALAVRAS_MULTIPLA)
+
+// Troca do metodo dos limitantes pela busca com varias origens nos pesos 1: custo de um lote de
+// ORIGENS_MULTIPLA origens, em buscas em largura simples, e quantas rodadas compoem cada janela
+// em que se mede o ritmo de descarte (so em componentes com pelo menos o minimo de vertices)
+#define CUSTO_LOTE_MULTIPLA (8 * PALAVRAS_MULTIPLA)
+#define JANELA_LIMITANTES 16
+#define MINIMO_VERTICES_MULTIPLA_LIMITANTES (4 * ORIGENS_MULTIPLA)
+
+// Instrumentacao opcional (compilar com -DGRAFO_STATS): cada thread soma seus contadores em
+// variaveis proprias, juntadas ao grafo no fim de cada funcao da biblioteca ou de cada trabalhador.
+// Sem GRAFO_STATS, as macros nao geram codigo algum
+#ifdef GRAFO_STATS
+#define CONTA(campo, quantidade) (contadores_da_thread.campo += (uint64_t) (quantidade))
+#define ESTATISTICA(comandos) comandos
+#define MEDE_FUNCAO(g, funcao) medicao medicao_funcao __attribute__((cleanup(termina_medicao))) = inicia_medicao(g, funcao)
+#else
+#define CONTA(campo, quantidade) ((void) 0)
+#define ESTATISTICA(comandos)
+#define MEDE_FUNCAO(g, funcao) ((void) 0)
+#endif
+
+// aresta lida da entrada ou inserida, guardada so ate a (re)construcao da adjacencia
 typedef struct {
-	char *nome_ponta;
-	unsigned int peso_aresta;
+	unsigned int u;
+	unsigned int v;
+	unsigned int peso;
 } aresta;
 
-// vertice tem um nome e seus vizinhos
+// lista de arestas lidas, que cresce por duplicacao
 typedef struct {
-	char *nome;
-	unsigned int grau;
-	unsigned int estado;
-	unsigned int componente;
 	aresta *arestas;
+	unsigned int tamanho;
+	unsigned int capacidade;
+} lista_arestas;
+
+// conjuntos disjuntos dos vertices (union-find com compressao de caminhos e uniao por rank),
+// mantidos pelas insercoes para responder n_componentes e bipartido em O(1)
+// paridade[v] e a paridade do caminho de v ate pai[v]: dois vertices do mesmo conjunto tem a
+// mesma cor numa bipartição se e so se suas paridades ate a raiz sao iguais
+// tamanho[r] e o numero de vertices do conjunto de raiz r (so vale nas raizes)
+typedef struct {
+	unsigned int *pai;
+	unsigned char *rank;
+	unsigned char *paridade;
+	unsigned int *tamanho;
+	unsigned int num_elementos;
+	unsigned int capacidade;
+	unsigned int num_conjuntos;
+	unsigned int bipartido;
+} uniao_busca;
+
+// blocos (componentes biconexas) de g mantidos aresta a aresta pelas insercoes: uma floresta
+// geradora (pai, UINT_MAX nas raizes, profundidade e listas duplamente encadeadas de filhos) e uma
+// uniao-busca sobre as arestas da floresta em que cada classe e um bloco
+// aresta[v] e o elemento da aresta v -- pai[v]; nas raizes de classe, tamanho_bloco e o numero de
+// arestas da floresta no bloco e topo o vertice mais alto dele (o unico vertice do bloco cuja
+// aresta para o pai fica fora do bloco), e num_topos[v] conta os blocos com topo v
+// Assim, v e vertice de corte se tem pai e e topo de algum bloco, ou se e raiz e topo de dois, e
+// uma aresta da floresta e ponte se esta sozinha no seu bloco
+// caminho e espaco de trabalho de reenraiza_blocos e liga_blocos; pai_bloco, topo e tamanho_bloco
+// sao indexados por elemento e tem 2 * capacidade posicoes
+typedef struct {
+	unsigned int *pai;
+	unsigned int *profundidade;
+	unsigned int *primeiro_filho;
+	unsigned int *proximo_irmao;
+	unsigned int *irmao_anterior;
+	unsigned int *aresta;
+	unsigned int *num_topos;
+	unsigned int *caminho;
+	unsigned int num_vertices;
+	unsigned int capacidade;
+	unsigned int *pai_bloco;
+	unsigned int *topo;
+	unsigned int *tamanho_bloco;
+	unsigned int num_elementos;
+} blocos_incrementais;
+
+// tipos de linha da entrada
+typedef enum {
+	LINHA_IGNORADA,	// comentario ou linha vazia
+	LINHA_VERTICE,	// nome de um vertice (a linha inteira)
+	LINHA_ARESTA	// "xxx -- yyy ppp"
+} tipo_linha;
+
+// partes de uma linha da entrada, apontando para dentro da propria linha
+typedef struct {
+	const char *nome1;
+	size_t tamanho1;
+	const char *nome2;
+	size_t tamanho2;
+	unsigned int peso;
+} linha_lida;
+
+// vertice tem um nome; seus vizinhos ficam na adjacencia do grafo
+typedef struct {
+	char *nome;
+	unsigned int hash;
 } vertice;
 
-// grafo guarda o nome e seus vertices
+// bloco de uma arena: os dados vem logo depois do cabecalho e os blocos formam uma lista
+typedef struct bloco_arena {
+	struct bloco_arena *anterior;
+	size_t tamanho;
+	size_t usado;
+	char dados[];
+} bloco_arena;
+
+// arena dos nomes de um grafo: cada nome ocupa o proximo pedaco livre do bloco atual e,
+// quando ele enche, um bloco maior (ate TAMANHO_MAXIMO_BLOCO_ARENA) e alocado
+// nada e liberado individualmente; destroi_grafo libera os poucos blocos de uma vez
+typedef struct {
+	bloco_arena *atual;
+	size_t num_blocos;
+	size_t bytes_reservados;
+	size_t bytes_usados;
+	size_t num_alocacoes;
+} arena;
+
+#ifdef GRAFO_STATS
+// contadores de uma thread, ainda nao juntados a estatisticas de um grafo
+typedef struct {
+	uint64_t vertices_visitados;
+	uint64_t arestas_examinadas;
+	uint64_t execucoes_sssp;
+	uint64_t operacoes_fila;
+	uint64_t bytes_alocados;
+} contadores;
+
+static __thread contadores contadores_da_thread;
+#endif
+
+// resultados das buscas sobre o grafo (definida mais abaixo)
+typedef struct grafo_analise grafo_analise;
+
+// grafo guarda o nome, seus vertices e a adjacencia em formato CSR:
+// (os nomes, o do grafo e os dos vertices, ficam na arena nomes)
+// os vizinhos do vertice i (e os pesos das arestas) estao nas posicoes
+// inicio_adj[i] .. inicio_adj[i+1]-1 de vizinhos (e de pesos)
+// a adjacencia cobre os vertices_adj primeiros vertices; arestas inseridas depois ficam em
+// pendentes ate a proxima consulta que precise da adjacencia (garante_adjacencia)
+// conjuntos so existe depois da primeira insercao e blocos depois da primeira consulta de cortes
+// feita depois de alguma insercao
+// posto_nome[v] e a posicao de v na ordem alfabetica dos nomes e ordem_nomes e a permutacao
+// inversa; os dois sao calculados sob demanda (calcula_postos) e valem para os vertices_postos
+// primeiros vertices, ja que os nomes nunca mudam e vertices novos vao sempre para o fim
 struct grafo {
 	char *nome;
 	unsigned int num_vertices;
 	unsigned int num_arestas;
 	vertice *vertices;	
+	unsigned int capacidade_vertices;
+	arena nomes;
+	unsigned int *tabela_hash;
+	unsigned int capacidade_hash;
+	unsigned int *inicio_adj;
+	unsigned int *vizinhos;
+	unsigned int *pesos;
+	unsigned int peso_minimo;
+	unsigned int peso_maximo;
+	unsigned int num_threads;
+	modo_diametro modo_diametro;
+	unsigned int versao;
+	grafo_analise *analise;
+	void *mapa;
+	size_t tamanho_mapa;
+	lista_arestas pendentes;
+	unsigned int vertices_adj;
+	uniao_busca *conjuntos;
+	blocos_incrementais *blocos;
+	unsigned int *posto_nome;
+	unsigned int *ordem_nomes;
+	unsigned int vertices_postos;
+#ifdef GRAFO_STATS
+	estatisticas_grafo estatisticas;
+#endif
 };
 
-// dados da DFS - para encontrar vertices de corte
+// cabecalho da imagem binaria de um grafo (salva_grafo_binario)
+// as secoes vem depois do cabecalho, cada uma comecando num multiplo de 8 bytes, e
+// checksum cobre todos os bytes depois do cabecalho e, por ultimo, o proprio cabecalho
+// com o campo checksum zerado
 typedef struct {
-	unsigned int *tempo_descoberta;
-	unsigned int *low;
-	int *pai;
-	unsigned int *eh_corte;
-	unsigned int tempo_atual;
-} dados_dfs_vertice;
+	char magica[8];
+	uint32_t versao;
+	uint32_t marca_endian;
+	uint64_t tamanho_total;
+	uint64_t checksum;
+	uint32_t num_vertices;
+	uint32_t num_arestas;
+	uint32_t peso_minimo;
+	uint32_t peso_maximo;
+	uint32_t capacidade_hash;
+	uint32_t tem_nome;
+	uint64_t secao_nome;
+	uint64_t secao_offsets_nomes;
+	uint64_t secao_nomes;
+	uint64_t secao_hashes;
+	uint64_t secao_tabela_hash;
+	uint64_t secao_inicio_adj;
+	uint64_t secao_vizinhos;
+	uint64_t secao_pesos;
+} cabecalho_binario;
+
+// escrita sequencial da imagem binaria: acumula o checksum palavra a palavra
+// (pendente guarda os bytes de uma palavra ainda incompleta) e conta a posicao no arquivo
+typedef struct {
+	FILE *arquivo;
+	uint64_t checksum;
+	uint64_t posicao;
+	unsigned char pendente[8];
+	size_t num_pendentes;
+	unsigned int erro;
+} escritor_binario;
+
+// estrategia de caminhos minimos, escolhida a partir dos pesos das arestas
+typedef enum {
+	SSSP_BFS,	// todos os pesos sao 1
+	SSSP_BALDES,	// pesos limitados por PESO_MAXIMO_BALDES (fila de baldes de Dial)
+	SSSP_HEAP	// pesos quaisquer
+} modo_sssp;
+
+// entrada da fila de prioridade do djikstra (heap binario minimo)
+typedef struct {
+	uint64_t distancia;
+	unsigned int vertice;
+} item_heap;
+
+// memoria de trabalho do djikstra, reaproveitada entre execucoes
+// distancias comeca toda em DISTANCIA_INFINITA e, a cada execucao, so as posicoes
+// dos vertices em alcancados sao alteradas (e restauradas na execucao seguinte)
+// os baldes sao listas duplamente encadeadas (prox_balde/ant_balde) indexadas por distancia % num_baldes
+typedef struct {
+	modo_sssp modo;
+	uint64_t *distancias;
+	unsigned int *alcancados;
+	unsigned int num_alcancados;
+	item_heap *heap;
+	size_t tamanho_heap;
+	size_t capacidade_heap;
+	unsigned int num_baldes;
+	unsigned int *baldes;
+	unsigned int *prox_balde;
+	unsigned int *ant_balde;
+} memoria_sssp;
+
+// conjunto de ate ORIGENS_MULTIPLA origens, um bit por origem, com as operacoes bit a bit do
+// vetor do GCC (|, &, ~) feitas sobre todas as palavras de uma vez
+typedef uint64_t bits_origens __attribute__((vector_size(8 * PALAVRAS_MULTIPLA)));
+
+// memoria de trabalho da busca em largura com varias origens (Then et al., MS-BFS), reaproveitada
+// entre execucoes e indexada por vertice: visto[v] tem as origens que ja alcancaram v, fronteira[v]
+// as que o alcancaram no nivel atual e proxima[v] as que o alcancam no seguinte
+// lista e proxima_lista tem os vertices com fronteira e proxima nao vazias, e visto e zerado pelos
+// vertices da componente no inicio de cada execucao
+// marca (sempre zerada entre usos) serve a agrupa_origens
+typedef struct {
+	bits_origens *visto;
+	bits_origens *fronteira;
+	bits_origens *proxima;
+	unsigned int *lista;
+	unsigned int *proxima_lista;
+	unsigned char *marca;
+} memoria_multipla;
+
+// argumento de cada thread criada por executa_em_threads_novas
+typedef struct {
+	void (*funcao)(void *contexto, unsigned int id_thread);
+	void *contexto;
+	unsigned int id_thread;
+} argumento_thread;
+
+// threads auxiliares mantidas entre as chamadas de executa_paralelo (de qualquer grafo), que
+// esperam trabalho em tem_trabalho em vez de serem criadas e juntadas a cada chamada
+// uso e do programa inteiro: quem nao consegue pega-lo (outra thread ja usando a reserva) cria
+// threads proprias. A cada chamada, geracao avanca e a auxiliar k executa funcao(contexto, k + 1)
+// se k + 1 < num_ids; pendentes conta as auxiliares que ainda nao terminaram
+typedef struct {
+	pthread_mutex_t uso;
+	pthread_mutex_t trava;
+	pthread_cond_t tem_trabalho;
+	pthread_cond_t terminou;
+	unsigned int num_auxiliares;
+	unsigned int geracao;
+	void (*funcao)(void *contexto, unsigned int id_thread);
+	void *contexto;
+	unsigned int num_ids;
+	unsigned int pendentes;
+} reserva_threads;
+
+// argumento de cada auxiliar da reserva: seu indice e a geracao em que foi criada
+typedef struct {
+	unsigned int indice;
+	unsigned int geracao;
+} argumento_auxiliar;
+
+static reserva_threads reserva = {
+	.uso = PTHREAD_MUTEX_INITIALIZER,
+	.trava = PTHREAD_MUTEX_INITIALIZER,
+	.tem_trabalho = PTHREAD_COND_INITIALIZER,
+	.terminou = PTHREAD_COND_INITIALIZER,
+	.num_auxiliares = 0,
+	.geracao = 0,
+	.funcao = NULL,
+	.contexto = NULL,
+	.num_ids = 0,
+	.pendentes = 0
+};
+static pthread_once_t reserva_registrada = PTHREAD_ONCE_INIT;
 
+// contexto compartilhado pelas threads que calculam excentricidades
+// cada tarefa e uma origem de ordem; as threads pegam a proxima tarefa livre num cursor atomico
+// e reduzem o maximo de cada componente em diametros com compare-and-swap
+typedef struct {
+	grafo *g;
+	unsigned int *ordem;
+	unsigned int *componente;
+	uint64_t *diametros;
+	unsigned int num_tarefas;
+	unsigned int proxima_tarefa;
+	unsigned int erro;
+} contexto_excentricidades;
+
+// contexto compartilhado pelas threads que calculam os diametros por buscas com varias origens
+// cada tarefa e um lote de ate ORIGENS_MULTIPLA origens consecutivas de origens, todas de uma
+// mesma componente: inicio_lote[t] e a posicao da primeira em origens e componente_lote[t] a
+// componente, cujos vertices estao em ordem e cujas origens terminam em fim_origens[c]
 typedef struct {
-	char *u;
-	char *v;
-} aresta_corte;
+	grafo *g;
+	unsigned int *ordem;
+	unsigned int *origens;
+	unsigned int *inicio_componente;
+	unsigned int *fim_origens;
+	unsigned int *inicio_lote;
+	unsigned int *componente_lote;
+	uint64_t *diametros;
+	unsigned int num_tarefas;
+	unsigned int proxima_tarefa;
+	unsigned int erro;
+} contexto_multipla;
+
+// contexto compartilhado pelas threads que calculam componentes (Afforest)
+// cada thread cuida de uma faixa fixa de vertices; pai e uma floresta de uniao-busca sem travas
+// em que pai[v] <= v sempre, entao a raiz de cada componente acaba sendo seu menor vertice
+// rodada e a posicao do vizinho ligado na fase de amostragem (ou RODADAS_AFFOREST, na fase final,
+// que liga os vizinhos restantes dos vertices fora de componente_grande)
+typedef struct {
+	grafo *g;
+	unsigned int *pai;
+	unsigned int num_threads;
+	unsigned int rodada;
+	unsigned int componente_grande;
+} contexto_componentes;
+
+// vertices descobertos por uma thread num passo de cima para baixo da busca por niveis
+typedef struct {
+	unsigned int *vertices;
+	unsigned int tamanho;
+	unsigned int capacidade;
+	uint64_t arestas;
+} descobertos_thread;
+
+// estado da busca em largura por niveis (busca_niveis), compartilhado pelas threads de cada passo
+// a fronteira e ordem[inicio_fronteira .. fim_fronteira-1] e, nos passos de baixo para cima,
+// tambem o mapa de bits fronteira; proxima recebe os bits da fronteira seguinte
+// num_partes e quantas threads dividem o passo atual (1 nos passos pequenos)
+typedef struct {
+	grafo *g;
+	unsigned int *nivel;
+	unsigned int *pai;
+	unsigned int *ordem;
+	unsigned int inicio_fronteira;
+	unsigned int fim_fronteira;
+	unsigned int nivel_atual;
+	uint64_t *fronteira;
+	uint64_t *proxima;
+	unsigned int num_palavras;
+	unsigned int num_partes;
+	descobertos_thread *descobertos;
+	unsigned int erro;
+} contexto_busca;
+
+// fases de cortes_paralelos executadas pelas threads
+typedef enum {
+	FASE_EXTREMOS,
+	FASE_UNIAO,
+	FASE_COMPRESSAO,
+	FASE_CORTES
+} fase_biconexas;
+
+// contexto compartilhado pelas threads de cortes_paralelos (Tarjan-Vishkin), cada uma com uma
+// faixa fixa de vertices. A arvore geradora e dada por pai, pelas posicoes em pre-ordem (pre) e
+// pelos tamanhos das subarvores (tamanho); os filhos de v sao filhos[inicio_filhos[v] ..]
+// baixo e alto comecam com a menor e a maior pre-ordem vizinha de cada vertice e depois passam
+// a valer para a subarvore toda. A aresta da arvore (pai[c], c) e representada por c em classe,
+// uma uniao-busca sem travas cujas classes sao os blocos (componentes biconexas)
+typedef struct {
+	grafo *g;
+	unsigned int num_threads;
+	fase_biconexas fase;
+	unsigned int *pai;
+	unsigned int *pre;
+	unsigned int *tamanho;
+	unsigned int *inicio_filhos;
+	unsigned int *filhos;
+	unsigned int *baixo;
+	unsigned int *alto;
+	unsigned int *classe;
+	unsigned int *eh_corte;
+	unsigned char *eh_ponte;
+} contexto_biconexas;
 
-// dados da DFS - para encontrar arestas de corte
+// contexto das threads que procuram uma aresta entre vertices de mesma cor
+typedef struct {
+	grafo *g;
+	unsigned char *cor;
+	unsigned int num_threads;
+	unsigned int conflito;
+} contexto_cores;
+
+// contexto compartilhado pelas threads que calculam diametros por limitantes
+// cada tarefa e uma componente inteira; como as componentes sao disjuntas, as threads
+// escrevem em posicoes distintas de ordem, exc_inf e exc_sup
+// componentes com tamanho_grande vertices ou mais ja foram resolvidas (com todas as threads
+// em cada rodada) e sao puladas; unitario diz se todos os pesos sao 1
+typedef struct {
+	grafo *g;
+	unsigned int *ordem;
+	unsigned int *inicio_componente;
+	unsigned int num_componentes;
+	unsigned int tamanho_grande;
+	unsigned int unitario;
+	uint64_t *diametros;
+	uint64_t *exc_inf;
+	uint64_t *exc_sup;
+	unsigned int proxima_componente;
+	unsigned int erro;
+} contexto_limitantes;
+
+// contexto de uma rodada de diametro_limitantes_paralelo: a thread t calcula a excentricidade
+// de origens[t] com mem[t] e a guarda em excentricidades[t]
+typedef struct {
+	grafo *g;
+	unsigned int *origens;
+	memoria_sssp **mem;
+	uint64_t *excentricidades;
+	unsigned int num_origens;
+} contexto_rodada;
+
+// vertices de corte e pontes de um grafo, obtidos numa unica busca em profundidade
+// eh_corte[v] = 1 se v e vertice de corte; pontes guarda num_pontes pares de indices
+// tempo_descoberta, low e pai (UINT_MAX nas raizes) sao os dados de low-link da busca (ou, em
+// cortes_paralelos, a pre-ordem, os menores vizinhos das subarvores e a arvore da busca por niveis)
+// depois de ordena_cortes, vertices_ordenados tem os num_vertices_corte vertices de corte e pontes
+// tem cada par com as pontas em ordem alfabetica, ambos na ordem alfabetica das respostas
+// bloco[v] (menor que o numero de vertices) identifica o bloco da aresta v -- pai[v] na arvore pai,
+// que vem da busca que calculou os cortes
+// indexa_cortes preenche, sob demanda, no_arvore (o no de cada vertice na arvore de blocos e
+// vertices de corte: os num_blocos blocos primeiro, depois os vertices de corte em ordem alfabetica)
+// e componente_sem_pontes (a componente de cada vertice no grafo sem as pontes)
 typedef struct {
+	unsigned int *eh_corte;
+	unsigned int *vertices_ordenados;
+	unsigned int num_vertices_corte;
+	unsigned int *pontes;
+	unsigned int num_pontes;
 	unsigned int *tempo_descoberta;
 	unsigned int *low;
-	int *pai;
-	unsigned int tempo_atual;
-} dados_dfs_aresta;
+	unsigned int *pai;
+	unsigned int *bloco;
+	unsigned int *no_arvore;
+	unsigned int *componente_sem_pontes;
+	unsigned int num_blocos;
+} cortes;
+
+// resultados das buscas sobre um grafo, calculados sob demanda e guardados enquanto o grafo
+// nao muda (versao). Uma unica busca em largura por niveis da as componentes e as cores e uma unica
+// busca em profundidade da os low-links, os vertices de corte e as pontes
+// ordem guarda os vertices agrupados por componente (por nivel da busca em largura, ou em ordem
+// crescente se as componentes vieram de componentes_paralelas), e
+// inicio_componente[c] .. inicio_componente[c+1]-1 sao as posicoes da componente c em ordem
+// a componente c e sempre a que tem o c-esimo menor "menor vertice", com ou sem threads
+// cor (a paridade do nivel de cada vertice) vem junto com a busca em largura; bipartido so e
+// conferido sob demanda, por calcula_cores (tem_cores)
+// diametros (um por componente) ja fica em ordem nao decrescente
+struct grafo_analise {
+	unsigned int versao;
+	unsigned int tem_componentes;
+	unsigned int tem_cores;
+	unsigned int num_componentes;
+	unsigned int *componente;
+	unsigned int *ordem;
+	unsigned int *inicio_componente;
+	unsigned int bipartido;
+	unsigned char *cor;
+	cortes *dados_cortes;
+	uint64_t *diametros;
+};
+
+// construcao de um grafo a partir de arestas com identificadores inteiros
+// g e o grafo em construcao: as arestas ficam em g->pendentes, pre-dimensionada pela estimativa,
+// e os vertices so sao criados em builder_finaliza
+// estimativa_vertices so dimensiona a lista de vertices e a tabela hash; num_vertices e o numero
+// de vertices que o grafo tera (1 + maior identificador, ou o definido por builder_define_num_vertices)
+struct grafo_builder {
+	grafo *g;
+	unsigned int estimativa_vertices;
+	unsigned int num_vertices;
+};
+
+// nome visto por algum pedaco da leitura paralela, guardado na tabela compartilhada
+// primeira e o menor par (pedaco, indice local) em que o nome aparece, e decide o indice final
+typedef struct {
+	const char *nome;
+	size_t tamanho;
+	unsigned int hash;
+	uint64_t primeira;
+	unsigned int indice;
+} nome_compartilhado;
+
+// fatia da tabela de nomes compartilhada entre as threads, com sua propria trava
+// tabela guarda posicoes de nomes (sondagem linear), e nomes so cresce, entao as posicoes nao mudam
+typedef struct {
+	pthread_mutex_t trava;
+	nome_compartilhado *nomes;
+	unsigned int num_nomes;
+	unsigned int capacidade_nomes;
+	unsigned int *tabela;
+	unsigned int capacidade_tabela;
+} fatia_nomes;
+
+// nome visto por um pedaco, com a posicao de sua entrada na fatia compartilhada
+typedef struct {
+	const char *nome;
+	size_t tamanho;
+	unsigned int hash;
+	unsigned int entrada;
+} nome_local;
+
+// trecho da entrada lido por uma thread: os nomes recebem indices locais, na ordem em que
+// aparecem, e as arestas sao guardadas com esses indices
+typedef struct {
+	const char *inicio;
+	const char *fim;
+	nome_local *nomes;
+	unsigned int num_nomes;
+	unsigned int capacidade_nomes;
+	unsigned int *tabela;
+	unsigned int capacidade_tabela;
+	lista_arestas arestas;
+	unsigned int num_proprios;
+	unsigned int primeiro_indice;
+	unsigned int primeira_aresta;
+} pedaco_entrada;
+
+// contexto compartilhado pelas threads da leitura paralela
+typedef struct {
+	pedaco_entrada *pedacos;
+	fatia_nomes *fatias;
+	nome_local *nomes_vertices;
+	aresta *arestas;
+	unsigned int erro;
+} contexto_leitura;
+
+#ifdef GRAFO_STATS
+// medicao de uma funcao da biblioteca, do inicio (em segundos) ate o fim do escopo
+typedef struct {
+	grafo *g;
+	funcao_estatistica funcao;
+	double inicio;
+} medicao;
+#endif
+
+// vertice com seu nome, para a ordenacao alfabetica (nome precisa ser o primeiro campo)
+typedef struct {
+	const char *nome;
+	unsigned int indice;
+} vertice_nomeado;
 
 /* -------------------------- DECLARAÇÃO DE FUNÇÕES (evitar problemas com o compilador) -------------------------- */
-void remove_quebra_linha(char *str);
-vertice *busca_ou_cria_vertice(grafo *g, const char *nome);
-void adiciona_aresta(vertice *vert, const char *destino, unsigned int peso);
-char *copia_str(const char *str);
+unsigned int hash_nome(const char *nome, size_t tamanho);
+unsigned int busca_posicao_hash(grafo *g, const char *nome, size_t tamanho, unsigned int hash);
+unsigned int redimensiona_hash(grafo *g, unsigned int nova_capacidade);
+unsigned int busca_ou_cria_vertice(grafo *g, const char *nome, size_t tamanho);
+void adiciona_aresta(lista_arestas *lista, unsigned int u, unsigned int v, unsigned int peso);
+unsigned int constroi_adjacencia(grafo *g);
+unsigned int garante_adjacencia(grafo *g);
+char *aloca_arena(arena *a, size_t tamanho);
+void libera_arena(arena *a);
+char *copia_str(arena *a, const char *str, size_t tamanho);
+unsigned int eh_branco(char c);
+tipo_linha interpreta_linha(const char *linha, size_t tamanho, linha_lida *lida);
+void processa_linha(grafo *g, lista_arestas *lidas, const char *linha, size_t tamanho);
+size_t processa_bloco(grafo *g, lista_arestas *lidas, const char *bloco, size_t tamanho, unsigned int fim_da_entrada);
+unsigned int le_arquivo_mapeado(FILE *f, grafo *g, lista_arestas *lidas);
+unsigned int le_em_blocos(FILE *f, grafo *g, lista_arestas *lidas);
+char *le_entrada_inteira(FILE *f, size_t *tamanho, size_t *tamanho_mapa);
+unsigned int registra_nome_compartilhado(fatia_nomes *fatia, const char *nome, size_t tamanho, unsigned int hash, uint64_t primeira);
+unsigned int interna_local(pedaco_entrada *pedaco, unsigned int id_pedaco, fatia_nomes *fatias, const char *nome, size_t tamanho);
+void trabalhador_leitura(void *contexto, unsigned int id_thread);
+void trabalhador_proprios(void *contexto, unsigned int id_thread);
+void trabalhador_indices(void *contexto, unsigned int id_thread);
+void trabalhador_arestas(void *contexto, unsigned int id_thread);
+void libera_leitura(contexto_leitura *ctx, unsigned int num_pedacos);
+grafo *cria_grafo_vazio(void);
+unsigned int materializa_grafo(grafo *g);
+uint64_t mistura64(uint64_t x);
+uint64_t atualiza_checksum(uint64_t checksum, const unsigned char *dados, size_t tamanho);
+uint64_t checksum_imagem(const cabecalho_binario *cab, uint64_t checksum_secoes);
+void escreve_bytes(escritor_binario *esc, const void *dados, size_t tamanho);
+void alinha_secao(escritor_binario *esc);
+unsigned int secao_valida(const cabecalho_binario *cab, uint64_t inicio, uint64_t tamanho);
+unsigned int imagem_consistente(const cabecalho_binario *cab, const unsigned char *base);
 unsigned int indice_do_vertice(grafo *g, const char *nome);
-unsigned int *djikstra(grafo *g, unsigned int origem);
-unsigned int diametro_componente(grafo *g, unsigned int *vertices_componente, unsigned int tamanho_componente);
-void dfs_corte_vertices(grafo *g, unsigned int u, dados_dfs_vertice *dados);
+memoria_sssp *cria_memoria_sssp(grafo *g);
+void destroi_memoria_sssp(memoria_sssp *mem);
+void insere_heap(memoria_sssp *mem, uint64_t distancia, unsigned int v);
+item_heap remove_min_heap(memoria_sssp *mem);
+void limpa_memoria_sssp(memoria_sssp *mem, unsigned int origem);
+uint64_t bfs_sssp(grafo *g, unsigned int origem, memoria_sssp *mem);
+void insere_balde(memoria_sssp *mem, unsigned int v, uint64_t distancia);
+void remove_balde(memoria_sssp *mem, unsigned int v, uint64_t distancia);
+uint64_t djikstra_baldes(grafo *g, unsigned int origem, memoria_sssp *mem);
+uint64_t djikstra_heap(grafo *g, unsigned int origem, memoria_sssp *mem);
+uint64_t djikstra(grafo *g, unsigned int origem, memoria_sssp *mem);
+uint64_t diametro_componente(grafo *g, unsigned int *vertices_componente, unsigned int tamanho_componente, memoria_sssp *mem);
+memoria_multipla *cria_memoria_multipla(grafo *g);
+void destroi_memoria_multipla(memoria_multipla *mem);
+uint64_t algum_bit(bits_origens b);
+uint64_t excentricidade_multipla(grafo *g, unsigned int *origens, unsigned int num_origens, unsigned int *vertices_componente, unsigned int tamanho_componente, memoria_multipla *mem);
+unsigned int escolhe_candidato(grafo *g, unsigned int *candidatos, unsigned int num_candidatos, uint64_t *exc_inf, uint64_t *exc_sup, unsigned int busca_periferia);
+void atualiza_limitantes(unsigned int *candidatos, unsigned int num_candidatos, uint64_t *distancias, uint64_t excentricidade, uint64_t *exc_inf, uint64_t *exc_sup, uint64_t *diametro_inf);
+unsigned int descarta_candidatos(unsigned int *candidatos, unsigned int num_candidatos, uint64_t *exc_sup, uint64_t diametro_inf);
+void agrupa_origens(grafo *g, unsigned int *candidatos, unsigned int num_candidatos, unsigned int *origens, unsigned char *marca, unsigned int *fila);
+unsigned int vale_busca_multipla(unsigned int descartados, unsigned int buscas);
+uint64_t diametro_candidatos_multipla(grafo *g, unsigned int *candidatos, unsigned int num_candidatos, unsigned int tamanho_componente, memoria_multipla *mem);
+uint64_t diametro_limitantes(grafo *g, unsigned int *candidatos, unsigned int tamanho_componente, memoria_sssp *mem, memoria_multipla **mem_multipla, uint64_t *exc_inf, uint64_t *exc_sup);
+void trabalhador_rodada(void *contexto, unsigned int id_thread);
+unsigned int diametro_limitantes_paralelo(grafo *g, unsigned int *candidatos, unsigned int tamanho_componente, uint64_t *exc_inf, uint64_t *exc_sup, unsigned int num_threads, unsigned int unitario, uint64_t *diametro);
+unsigned int diametro_candidatos_paralelo(grafo *g, unsigned int *candidatos, unsigned int num_candidatos, unsigned int tamanho_componente, unsigned int num_threads, uint64_t *diametro);
+unsigned int threads_efetivas(grafo *g);
+void *inicia_thread(void *arg);
+void executa_em_threads_novas(unsigned int num_threads, void (*funcao)(void *, unsigned int), void *contexto);
+void *trabalha_na_reserva(void *arg);
+void esvazia_reserva_no_filho(void);
+void registra_reserva(void);
+void aumenta_reserva(unsigned int quantidade);
+void executa_paralelo(unsigned int num_threads, void (*funcao)(void *, unsigned int), void *contexto);
+void maximo_atomico(uint64_t *destino, uint64_t valor);
+void trabalhador_excentricidades(void *contexto, unsigned int id_thread);
+unsigned int excentricidades_paralelas(grafo *g, unsigned int *ordem, unsigned int *componente, uint64_t *diametros_componentes, unsigned int num_threads);
+void trabalhador_multipla(void *contexto, unsigned int id_thread);
+unsigned int diametros_multiplos(grafo *g, unsigned int *ordem, unsigned int *inicio_componente, unsigned int num_componentes, uint64_t *diametros_componentes, unsigned int num_threads);
+void trabalhador_limitantes(void *contexto, unsigned int id_thread);
+unsigned int diametros_por_limitantes(grafo *g, unsigned int *ordem, unsigned int *inicio_componente, unsigned int num_componentes, uint64_t *diametros_componentes, unsigned int num_threads);
+cortes *calcula_cortes(grafo *g);
+void trabalhador_biconexas(void *contexto, unsigned int id_thread);
+cortes *cortes_paralelos(grafo *g, unsigned int num_threads, blocos_incrementais *blocos);
+void destroi_cortes(cortes *c);
+unsigned int calcula_postos(grafo *g);
+unsigned int ordena_cortes(grafo *g, cortes *c);
+unsigned int indexa_cortes(grafo *g, cortes *c);
+void limpa_analise(grafo_analise *a);
+grafo_analise *analise_atual(grafo *g);
+grafo_analise *obtem_analise(grafo *g);
+unsigned int calcula_componentes(grafo *g, grafo_analise *a);
+void passo_cima_baixo(void *contexto, unsigned int id_thread);
+void passo_baixo_cima(void *contexto, unsigned int id_thread);
+unsigned int busca_niveis(grafo *g, unsigned int num_threads, unsigned int *nivel, unsigned int *pai, unsigned int *ordem, unsigned int *inicio_componente, unsigned int *num_componentes);
+void trabalhador_cores(void *contexto, unsigned int id_thread);
+unsigned int confere_cores(grafo *g, unsigned char *cor, unsigned int num_threads);
+void une_atomico(unsigned int *pai, unsigned int u, unsigned int v);
+void comprime_faixa(unsigned int *pai, unsigned int inicio, unsigned int fim);
+void trabalhador_componentes(void *contexto, unsigned int id_thread);
+void trabalhador_compressao(void *contexto, unsigned int id_thread);
+unsigned int componente_frequente(unsigned int *pai, unsigned int num_vertices);
+unsigned int componentes_paralelas(grafo *g, grafo_analise *a, unsigned int num_threads);
+unsigned int calcula_cores(grafo *g, grafo_analise *a);
+grafo_analise *analise_componentes(grafo *g);
+grafo_analise *analise_bipartido(grafo *g);
+grafo_analise *analise_cortes(grafo *g);
+grafo_analise *analise_indice_cortes(grafo *g);
+grafo_analise *analise_diametros(grafo *g);
+unsigned int ordem_cuthill_mckee(grafo *g, unsigned int *ordem);
+unsigned int ordem_largura(grafo *g, unsigned int *ordem);
+unsigned int ordem_grau(grafo *g, unsigned int *ordem);
+unsigned int aplica_ordem(grafo *g, const unsigned int *ordem);
+void destroi_conjuntos(uniao_busca *c);
+unsigned int reserva_conjuntos(uniao_busca *c, unsigned int capacidade);
+void acompanha_vertices(uniao_busca *c, unsigned int num_vertices);
+unsigned int busca_conjunto(uniao_busca *c, unsigned int x, unsigned char *paridade);
+void une_conjuntos(uniao_busca *c, unsigned int u, unsigned int v);
+uniao_busca *cria_conjuntos(grafo *g);
+void destroi_blocos(blocos_incrementais *b);
+unsigned int reserva_blocos(blocos_incrementais *b, unsigned int capacidade);
+void acompanha_blocos(blocos_incrementais *b, unsigned int num_vertices);
+blocos_incrementais *cria_blocos(grafo *g);
+void inicia_blocos(blocos_incrementais *b, unsigned int num_vertices, const unsigned int *pai, const unsigned int *classe);
+unsigned int busca_bloco(blocos_incrementais *b, unsigned int x);
+unsigned int une_blocos(blocos_incrementais *b, unsigned int x, unsigned int y);
+void adiciona_filho(blocos_incrementais *b, unsigned int p, unsigned int v);
+void remove_filho(blocos_incrementais *b, unsigned int p, unsigned int v);
+void reenraiza_blocos(blocos_incrementais *b, unsigned int v);
+void liga_blocos(blocos_incrementais *b, unsigned int u, unsigned int v);
+void fecha_ciclo_blocos(blocos_incrementais *b, unsigned int u, unsigned int v);
+void insere_aresta_blocos(grafo *g, unsigned int u, unsigned int v);
+cortes *cortes_dos_blocos(grafo *g);
+unsigned int prepara_insercao(grafo *g);
+char *string_vazia(void);
+char *junta_nomes(grafo *g, const unsigned int *ids, unsigned int quantidade);
 int compara_nome_vertices(const void *a, const void *b);
-void dfs_corte_arestas(grafo *g, unsigned int u, dados_dfs_aresta *dados, aresta_corte *arestas, unsigned int *contador);
-int compara_nome_arestas(const void *a, const void *b);
-int compara_uint(const void *a, const void *b);
+int compara_uint64(const void *a, const void *b);
+#ifdef GRAFO_STATS
+double relogio(void);
+void junta_contadores(grafo *g);
+medicao inicia_medicao(grafo *g, funcao_estatistica funcao);
+void termina_medicao(medicao *m);
+#endif
 
 /* -------------------------- FUNÇÕES AUXILIARES -------------------------- */
-// Remove o \n de str
-void remove_quebra_linha(char *str) {
-	char *quebra = strchr(str, '\n');
-	
-	if (quebra)
-		*quebra = '\0';
-}
+// Calcula o hash (FNV-1a) de um nome de vertice com tamanho caracteres
+unsigned int hash_nome(const char *nome, size_t tamanho) {
+	unsigned int hash = 2166136261u;
 
-// Se vertice com o nome ja existe, o retorna. Se não existe, cria um novo com esse nome e o retorna.
-vertice *busca_ou_cria_vertice(grafo *g, const char *nome) {
-	// Se encontra o vertice, o retorna
-	for (unsigned int i = 0; i < g->num_vertices; i++) {
-		if (strcmp(g->vertices[i].nome, nome) == 0)
-			return &g->vertices[i];
+	for (size_t i = 0; i < tamanho; i++) {
+		hash ^= (unsigned char) nome[i];
+		hash *= 16777619u;
 	}
 
-	// Se nao encontra o vertice, aumenta tamanho da lista de vertices e cria 
-	vertice *realocacao_vert;
-	realocacao_vert = realloc(g->vertices, (g->num_vertices+1) * sizeof(vertice)); 
-	if (!realocacao_vert) {
-		exit(-1);
-	}
-	g->vertices = realocacao_vert;
+	return hash;
+}
 
-	vertice *vert = &g->vertices[g->num_vertices];
-	vert->nome = copia_str(nome);
-	vert->grau = 0;
-	vert->arestas = NULL;
-	g->num_vertices++;
+// Retorna a posicao da tabela hash onde esta o vertice com esse nome ou, se ele nao existe,
+// a posicao vazia onde ele deveria ser inserido (sondagem linear)
+// nome nao precisa terminar em '\0': so seus tamanho primeiros caracteres sao considerados
+unsigned int busca_posicao_hash(grafo *g, const char *nome, size_t tamanho, unsigned int hash) {
+	unsigned int mascara = g->capacidade_hash - 1;
+	unsigned int posicao = hash & mascara;
 
-	return vert;
-}
+	while (g->tabela_hash[posicao] != HASH_VAZIO) {
+		vertice *vert = &g->vertices[g->tabela_hash[posicao]];
 
-// Adiciona uma aresta vert -- destino com o peso passado como parametro
-void adiciona_aresta(vertice *vert, const char *destino, unsigned int peso) {
-	aresta *realocacao_arestas;
+		if ((vert->hash == hash) && (memcmp(vert->nome, nome, tamanho) == 0) && (vert->nome[tamanho] == '\0'))
+			return posicao;
 
-	realocacao_arestas = realloc(vert->arestas, (size_t)(vert->grau+1) * sizeof(aresta)); 
-	if (!realocacao_arestas) {
-		exit(-1);
+		posicao = (posicao + 1) & mascara;
 	}
 
-	vert->arestas = realocacao_arestas;
-	vert->arestas[vert->grau].nome_ponta = copia_str(destino);
-	vert->arestas[vert->grau].peso_aresta = peso;
-	vert->grau++;
+	return posicao;
 }
 
-// Cria uma nova string com o mesmo conteudo de str 
-char *copia_str(const char *str) {
-	char *copia = (char*) malloc(strlen(str) + 1);
+// Realoca a tabela hash com nova_capacidade posicoes (potencia de 2) e reinsere todos os vertices
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int redimensiona_hash(grafo *g, unsigned int nova_capacidade) {
+	unsigned int *nova_tabela = (unsigned int*) malloc(sizeof(unsigned int) * nova_capacidade);
+	if (!nova_tabela) {
+		return 0;
+	}
 
-	if (copia)
-		strcpy(copia, str);
+	for (unsigned int i = 0; i < nova_capacidade; i++) {
+		nova_tabela[i] = HASH_VAZIO;
+	}
 
-	return copia;
-}
+	free(g->tabela_hash);
+	g->tabela_hash = nova_tabela;
+	g->capacidade_hash = nova_capacidade;
+	CONTA(bytes_alocados, sizeof(unsigned int) * nova_capacidade);
 
-// Retorna o indice do vertice na lista de vertices do grafo g
-// Se vertice nao existe, retorna UINT_MAX
-unsigned int indice_do_vertice(grafo *g, const char *nome) {
+	// Como os nomes sao unicos, basta achar a primeira posicao vazia
+	unsigned int mascara = nova_capacidade - 1;
 	for (unsigned int i = 0; i < g->num_vertices; i++) {
-		if (strcmp(g->vertices[i].nome, nome) == 0) {
-			return i;
-		}
-	}
-	return UINT_MAX;
-}
+		unsigned int posicao = g->vertices[i].hash & mascara;
 
-// aplica djikstra e retorna, em distancias, o valor da distancia de origem para cada um dos vertices do grafo
-unsigned int *djikstra(grafo *g, unsigned int origem) {
-	unsigned int *distancias = (unsigned int*) malloc(sizeof(unsigned int) * g->num_vertices);
-	unsigned int *visitados = (unsigned int*) malloc(sizeof(unsigned int) * g->num_vertices);
+		while (nova_tabela[posicao] != HASH_VAZIO) {
+			posicao = (posicao + 1) & mascara;
+		}
 
-	if ((!distancias) || (!visitados)) {
-		free(distancias);
-		free(visitados);
-		return NULL;
+		nova_tabela[posicao] = i;
 	}
 
-	// Inicializa todas as distancias com o maior valor possivel
-	for (unsigned int i = 0; i < g->num_vertices; i++) {
-		distancias[i] = UINT_MAX;
-		visitados[i] = 0;
-	}
+	return 1;
+}
 
-	// Distancia de um vertice para ele mesmo é 0
-	distancias[origem] = 0;
+// Se vertice com o nome (de tamanho caracteres) ja existe, retorna seu indice.
+// Se não existe, cria um novo com esse nome e retorna seu indice.
+unsigned int busca_ou_cria_vertice(grafo *g, const char *nome, size_t tamanho) {
+	// Se encontra o vertice, o retorna
+	unsigned int hash = hash_nome(nome, tamanho);
+	unsigned int posicao = g->capacidade_hash ? busca_posicao_hash(g, nome, tamanho, hash) : 0;
 
-	// Loop principal
-	for (unsigned int i = 0; i < g->num_vertices; i++) {
-		unsigned int min_indice = UINT_MAX;
-		unsigned int min_valor = UINT_MAX;
+	if ((g->capacidade_hash) && (g->tabela_hash[posicao] != HASH_VAZIO))
+		return g->tabela_hash[posicao];
 
-		for (unsigned int j = 0; j < g->num_vertices; j++) {
-			if ((!visitados[j]) && (distancias[j]) < min_valor) {
-				min_valor = distancias[j];
-				min_indice = j;
-			}
+	// Mantem a ocupacao da tabela em no maximo 1/2 (so cresce quando um vertice vai ser criado)
+	if (2 * (g->num_vertices + 1) > g->capacidade_hash) {
+		unsigned int nova_capacidade = g->capacidade_hash ? 2 * g->capacidade_hash : CAPACIDADE_HASH_INICIAL;
+
+		if (!redimensiona_hash(g, nova_capacidade)) {
+			exit(-1);
 		}
+		posicao = busca_posicao_hash(g, nome, tamanho, hash);
+	}
 
-		if (min_indice == UINT_MAX) {
-			break;
+	// Se nao encontra o vertice, aumenta a lista de vertices (por duplicacao) se preciso e cria
+	if (g->num_vertices == g->capacidade_vertices) {
+		unsigned int nova_capacidade = g->capacidade_vertices ? 2 * g->capacidade_vertices : 64;
+		vertice *realocacao_vert = realloc(g->vertices, (size_t) nova_capacidade * sizeof(vertice));
+		if (!realocacao_vert) {
+			exit(-1);
 		}
+		g->vertices = realocacao_vert;
+		g->capacidade_vertices = nova_capacidade;
+		CONTA(bytes_alocados, (size_t) nova_capacidade * sizeof(vertice));
+	}
 
-		visitados[min_indice] = 1;
-		vertice *vert = &g->vertices[min_indice];
+	vertice *vert = &g->vertices[g->num_vertices];
+	vert->nome = copia_str(&g->nomes, nome, tamanho);
+	if (!vert->nome) {
+		exit(-1);
+	}
+	vert->hash = hash;
+	g->tabela_hash[posicao] = g->num_vertices;
+	g->num_vertices++;
 
-		for (unsigned int j = 0; j < vert->grau; j++) {
-			char *nome_vizinho = vert->arestas[j].nome_ponta;
-			unsigned int indice_vizinho = indice_do_vertice(g, nome_vizinho);
-			unsigned int peso = vert->arestas[j].peso_aresta;
+	return g->num_vertices - 1;
+}
 
-			if ((indice_vizinho != UINT_MAX) && (!visitados[indice_vizinho])) {
-				unsigned int nova_distancia = distancias[min_indice] + peso;
-				if (nova_distancia < distancias[indice_vizinho]) {
-					distancias[indice_vizinho] = nova_distancia;
-				}
-			}
+// Adiciona a aresta u -- v com o peso passado como parametro ao fim da lista
+void adiciona_aresta(lista_arestas *lista, unsigned int u, unsigned int v, unsigned int peso) {
+	if (lista->tamanho == lista->capacidade) {
+		unsigned int nova_capacidade = lista->capacidade ? 2 * lista->capacidade : 64;
+		aresta *realocacao_arestas = realloc(lista->arestas, (size_t) nova_capacidade * sizeof(aresta));
+		if (!realocacao_arestas) {
+			exit(-1);
 		}
+
+		lista->arestas = realocacao_arestas;
+		lista->capacidade = nova_capacidade;
+		CONTA(bytes_alocados, (size_t) nova_capacidade * sizeof(aresta));
 	}
 
-	free(visitados);
-	return distancias;
+	lista->arestas[lista->tamanho].u = u;
+	lista->arestas[lista->tamanho].v = v;
+	lista->arestas[lista->tamanho].peso = peso;
+	lista->tamanho++;
 }
 
-// Calcula o diametro de uma componente conexa
-unsigned int diametro_componente(grafo *g, unsigned int *vertices_componente, unsigned int tamanho_componente) {
-	if ((tamanho_componente == 0) || (tamanho_componente == 1)) {
+// Monta a adjacencia CSR de g juntando a adjacencia atual (dos vertices_adj primeiros vertices)
+// com as arestas pendentes, que sao consumidas
+// Os vizinhos de cada vertice ficam na mesma ordem em que as arestas foram lidas ou inseridas
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int constroi_adjacencia(grafo *g) {
+	lista_arestas *lista = &g->pendentes;
+	size_t antigas = g->inicio_adj ? g->inicio_adj[g->vertices_adj] : 0;
+	size_t total = antigas + 2 * (size_t) lista->tamanho;
+
+	unsigned int *inicio = (unsigned int*) calloc((size_t) g->num_vertices + 1, sizeof(unsigned int));
+	unsigned int *vizinhos = (unsigned int*) malloc(sizeof(unsigned int) * (total ? total : 1));
+	unsigned int *pesos = (unsigned int*) malloc(sizeof(unsigned int) * (total ? total : 1));
+
+	if ((!inicio) || (!vizinhos) || (!pesos)) {
+		free(inicio);
+		free(vizinhos);
+		free(pesos);
 		return 0;
 	}
+	CONTA(bytes_alocados, sizeof(unsigned int) * ((size_t) g->num_vertices + 1 + 2 * total));
 
-	unsigned int diametro = 0;
-	for (unsigned int i = 0; i < tamanho_componente; i++) {
-		unsigned int origem = vertices_componente[i];
-		unsigned int *distancias = djikstra(g, origem);
+	// Conta o grau de cada vertice (inicio[i+1] = grau de i) e registra os pesos extremos,
+	// que decidem a estrategia de caminhos minimos (sem arestas, vale a busca em largura)
+	for (unsigned int i = 0; i < g->vertices_adj; i++) {
+		inicio[i + 1] = g->inicio_adj[i + 1] - g->inicio_adj[i];
+	}
 
-		if (!distancias) {
-			continue;
-		}
+	if (antigas == 0) {
+		g->peso_minimo = lista->tamanho ? UINT_MAX : 1;
+		g->peso_maximo = lista->tamanho ? 0 : 1;
+	}
+	for (unsigned int i = 0; i < lista->tamanho; i++) {
+		inicio[lista->arestas[i].u + 1]++;
+		inicio[lista->arestas[i].v + 1]++;
+
+		if (lista->arestas[i].peso < g->peso_minimo)
+			g->peso_minimo = lista->arestas[i].peso;
+		if (lista->arestas[i].peso > g->peso_maximo)
+			g->peso_maximo = lista->arestas[i].peso;
+	}
 
-		for (unsigned int j = 0; j < tamanho_componente; j++) {
-			unsigned int destino = vertices_componente[j];
+	// Soma de prefixos: inicio[i] passa a ser a posicao do primeiro vizinho de i
+	for (unsigned int i = 0; i < g->num_vertices; i++) {
+		inicio[i + 1] += inicio[i];
+	}
 
-			if ((destino != origem) && (distancias[destino] != UINT_MAX) && (distancias[destino] > diametro)) {
-				diametro = distancias[destino];
-			}
-		}
+	// Copia os vizinhos antigos e depois distribui as arestas pendentes, usando inicio[i] como
+	// cursor de escrita; no fim os inicios sao restaurados
+	for (unsigned int i = 0; i < g->vertices_adj; i++) {
+		unsigned int grau = g->inicio_adj[i + 1] - g->inicio_adj[i];
 
-		free(distancias);
+		memcpy(vizinhos + inicio[i], g->vizinhos + g->inicio_adj[i], sizeof(unsigned int) * grau);
+		memcpy(pesos + inicio[i], g->pesos + g->inicio_adj[i], sizeof(unsigned int) * grau);
+		inicio[i] += grau;
 	}
-	return diametro;
-}
 
-// Busca em profundidade auxiliar para analise dos vertices de corte
-void dfs_corte_vertices(grafo *g, unsigned int u, dados_dfs_vertice *dados) {
-	unsigned int filhos = 0;
-	dados->tempo_descoberta[u] = dados->tempo_atual;
-	dados->low[u] = dados->tempo_atual;
-	dados->tempo_atual++;
+	for (unsigned int i = 0; i < lista->tamanho; i++) {
+		aresta *a = &lista->arestas[i];
+		unsigned int pos_u = inicio[a->u]++;
+		vizinhos[pos_u] = a->v;
+		pesos[pos_u] = a->peso;
 
-	vertice *vert_u = &g->vertices[u];
+		unsigned int pos_v = inicio[a->v]++;
+		vizinhos[pos_v] = a->u;
+		pesos[pos_v] = a->peso;
+	}
 
-	for (unsigned int i = 0; i < vert_u->grau; i++) {
-		char *nome_vizinho = vert_u->arestas[i].nome_ponta;
-		unsigned int indice_vizinho = indice_do_vertice(g, nome_vizinho);
+	for (unsigned int i = g->num_vertices; i > 0; i--) {
+		inicio[i] = inicio[i - 1];
+	}
+	inicio[0] = 0;
 
-		if (indice_vizinho == UINT_MAX) {
-			continue;
-		}
+	free(g->inicio_adj);
+	free(g->vizinhos);
+	free(g->pesos);
+	g->inicio_adj = inicio;
+	g->vizinhos = vizinhos;
+	g->pesos = pesos;
+	g->vertices_adj = g->num_vertices;
 
-		if (dados->tempo_descoberta[indice_vizinho] == UINT_MAX) {
-			filhos++;
-			dados->pai[indice_vizinho] = (int) u;
-			dfs_corte_vertices(g, indice_vizinho, dados);
+	free(lista->arestas);
+	lista->arestas = NULL;
+	lista->tamanho = 0;
+	lista->capacidade = 0;
 
-			if (dados->low[indice_vizinho] < dados->low[u]) {
-				dados->low[u] = dados->low[indice_vizinho];
-			}
+	return 1;
+}
 
-			if ((dados->pai[u] != -1) && (dados->low[indice_vizinho] >= dados->tempo_descoberta[u])) {
-				dados->eh_corte[u] = 1;
-			}
-		} else if ((int)indice_vizinho != dados->pai[u]) {
-			if (dados->tempo_descoberta[indice_vizinho] < dados->low[u]) {
-				dados->low[u] = dados->tempo_descoberta[indice_vizinho];
-			}
-		}
+// Reconstroi a adjacencia de g se houve insercoes desde a ultima construcao
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int garante_adjacencia(grafo *g) {
+	if ((g->inicio_adj) && (g->pendentes.tamanho == 0) && (g->vertices_adj == g->num_vertices)) {
+		return 1;
 	}
 
-	if ((dados->pai[u] == -1) && (filhos >= 2)) {
-		dados->eh_corte[u] = 1;
-	} 
+	return materializa_grafo(g) && constroi_adjacencia(g);
 }
 
-// Função de comparação para ordenação alfabética
-int compara_nome_vertices(const void *a, const void *b) {
-	return strcmp(*(const char * const*)a, *(const char * const *)b);
-}
+// Reserva tamanho bytes na arena a, alocando um novo bloco se o atual nao tem espaco
+// Retorna NULL em caso de erro
+char *aloca_arena(arena *a, size_t tamanho) {
+	bloco_arena *bloco = a->atual;
 
-// Busca em profundidade auxiliar para analise das arestas de corte
-void dfs_corte_arestas(grafo *g, unsigned int u, dados_dfs_aresta *dados, aresta_corte *arestas, unsigned int *contador) {
-	dados->tempo_descoberta[u] = dados->tempo_atual;
-	dados->low[u] = dados->tempo_atual;
-	dados->tempo_atual++;
+	if ((!bloco) || (bloco->tamanho - bloco->usado < tamanho)) {
+		// Cada bloco novo tem o dobro do anterior, para que poucos blocos bastem
+		size_t tamanho_bloco = bloco ? 2 * bloco->tamanho : TAMANHO_BLOCO_ARENA;
+		if (tamanho_bloco > TAMANHO_MAXIMO_BLOCO_ARENA) {
+			tamanho_bloco = TAMANHO_MAXIMO_BLOCO_ARENA;
+		}
+		if (tamanho_bloco < tamanho) {
+			tamanho_bloco = tamanho;
+		}
 
-	vertice *vert_u = &g->vertices[u];
+		bloco_arena *novo = (bloco_arena*) malloc(sizeof(bloco_arena) + tamanho_bloco);
+		if (!novo) {
+			return NULL;
+		}
 
-	for (unsigned int i = 0; i < vert_u->grau; i++) {
-		char *nome_vizinho = vert_u->arestas[i].nome_ponta;
-		int indice_vizinho = (int) indice_do_vertice(g, nome_vizinho);
+		CONTA(bytes_alocados, sizeof(bloco_arena) + tamanho_bloco);
+		novo->anterior = bloco;
+		novo->tamanho = tamanho_bloco;
+		novo->usado = 0;
+		a->atual = novo;
+		a->num_blocos++;
+		a->bytes_reservados += tamanho_bloco;
+		bloco = novo;
+	}
 
-		if (indice_vizinho == -1) { 
-			continue;
-		}
+	char *espaco = bloco->dados + bloco->usado;
+	bloco->usado += tamanho;
+	a->bytes_usados += tamanho;
+	a->num_alocacoes++;
 
-		// Vizinho não visitado
-		if (dados->tempo_descoberta[indice_vizinho] == UINT_MAX) {
-			dados->pai[indice_vizinho] = (int) u;
-			dfs_corte_arestas(g, (unsigned int)indice_vizinho, dados, arestas, contador);
-			
-			// Atualiza low de u
-			if (dados->low[indice_vizinho] < dados->low[u]) {
-				dados->low[u] = dados->low[indice_vizinho];
-			}
-
-			// Verifica se a aresta é ponte
-			if (dados->low[indice_vizinho] > dados->tempo_descoberta[u]) {
-				// Armazena os nomes ordenados alfabeticamente
-				char *nome_u = g->vertices[u].nome;
-				char *nome_v = g->vertices[indice_vizinho].nome;
-
-				// Ordena alfabeticamente
-				if (strcmp(nome_u, nome_v) < 0) {
-					arestas[*contador].u = copia_str(nome_u);
-					arestas[*contador].v = copia_str(nome_v);
-				} else {
-					arestas[*contador].u = copia_str(nome_v);
-					arestas[*contador].v = copia_str(nome_u);
-				}
+	return espaco;
+}
 
-				(*contador)++;
-			}
-		} else if (indice_vizinho != dados->pai[u]) {
-			if (dados->tempo_descoberta[indice_vizinho] < dados->low[u]) {
-		 	 dados->low[u] = dados->tempo_descoberta[indice_vizinho];
-			}
-		}
+// Libera todos os blocos da arena a, que volta a ficar vazia
+void libera_arena(arena *a) {
+	while (a->atual) {
+		bloco_arena *anterior = a->atual->anterior;
+		free(a->atual);
+		a->atual = anterior;
 	}
+
+	a->num_blocos = 0;
+	a->bytes_reservados = 0;
+	a->bytes_usados = 0;
+	a->num_alocacoes = 0;
 }
 
-// Função de comparação para ordenação de arestas
-int compara_nome_arestas(const void *a, const void *b) {
-	const aresta_corte *aa = (const aresta_corte *)a;
-	const aresta_corte *ab = (const aresta_corte *)b;
+// Cria na arena a uma nova string com os tamanho primeiros caracteres de str
+char *copia_str(arena *a, const char *str, size_t tamanho) {
+	char *copia = aloca_arena(a, tamanho + 1);
 
-	// Compara primeiro vértice
-	int cmp_u = strcmp(aa->u, ab->u);
-	if (cmp_u != 0) { 
-		return cmp_u;
-	} 
+	if (copia) {
+		memcpy(copia, str, tamanho);
+		copia[tamanho] = '\0';
+	}
 
-	// Se primeiro igual, compara segundo
-	return strcmp(aa->v, ab->v);
+	return copia;
 }
 
-// Função de comparação para ordenação não decrescente de diametros
-int compara_uint(const void *a, const void *b) {
-	unsigned int da = *(const unsigned int *)a;
-	unsigned int db = *(const unsigned int *)b;
-
-	return ((da > db) - (da < db));
+// Retorna 1 se c e um caractere branco (os mesmos de isspace no locale C)
+unsigned int eh_branco(char c) {
+	return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\v') || (c == '\f') || (c == '\r');
 }
-/* -------------------------- FUNÇÕES DA BIBLIOTECA -------------------------- */
-// lê um grafo de f e o devolve
-grafo *le_grafo(FILE *f) {
-	char linha[MAX_LINHA];
-	
-	grafo *grafo_lido = malloc(sizeof(grafo));
-	if (!grafo_lido) {
-		printf("[le_grafo] erro em malloc.\n");
-		return NULL;
-	}
 
-	grafo_lido->nome = NULL;
-	grafo_lido->num_vertices = 0;
-	grafo_lido->num_arestas = 0;
-	grafo_lido->vertices = NULL;
+// Separa as partes de uma linha da entrada (sem o \n), com as mesmas regras de antes:
+// comentarios e linhas vazias sao ignorados, "xxx -- yyy ppp" e uma aresta (ppp opcional)
+// e qualquer outra linha e o nome de um vertice
+tipo_linha interpreta_linha(const char *linha, size_t tamanho, linha_lida *lida) {
+	// Se é comentario ou linha vazia, ignora
+	if ((tamanho == 0) || ((tamanho >= 2) && (linha[0] == '/') && (linha[1] == '/')))
+		return LINHA_IGNORADA;
+
+	const char *fim = linha + tamanho;
+	const char *p = linha;
+
+	// Primeiro nome: sequencia de nao brancos
+	while ((p < fim) && eh_branco(*p))
+		p++;
+	const char *nome1 = p;
+	while ((p < fim) && !eh_branco(*p))
+		p++;
+	size_t tamanho1 = (size_t) (p - nome1);
+
+	// Separador "--", com brancos opcionais dos dois lados
+	while ((p < fim) && eh_branco(*p))
+		p++;
+	unsigned int eh_aresta = (tamanho1 > 0) && (fim - p >= 2) && (p[0] == '-') && (p[1] == '-');
+
+	const char *nome2 = NULL;
+	size_t tamanho2 = 0;
+	if (eh_aresta) {
+		p += 2;
+		while ((p < fim) && eh_branco(*p))
+			p++;
+		nome2 = p;
+		while ((p < fim) && !eh_branco(*p))
+			p++;
+		tamanho2 = (size_t) (p - nome2);
+		eh_aresta = (tamanho2 > 0);
+	}
 
-	while (fgets(linha, MAX_LINHA, f)) {
-		remove_quebra_linha(linha);
+	// Se é linha de definicao de vertice, o nome é a linha inteira
+	if (!eh_aresta) {
+		lida->nome1 = linha;
+		lida->tamanho1 = tamanho;
+		return LINHA_VERTICE;
+	}
 
-		// Se é comentario, ignora
-		if ((linha[0] == '/') && (linha[1] == '/'))
-			continue;
+	// Peso opcional, lido como em scanf("%u"): sinal opcional seguido de digitos
+	unsigned int peso = 1;
+	while ((p < fim) && eh_branco(*p))
+		p++;
 
-		// Se começar com caractere nulo (era só \n antes da remocao), ignora
-		if (linha[0] == '\0')
-			continue;
+	unsigned int negativo = 0;
+	if ((p < fim) && ((*p == '+') || (*p == '-'))) {
+		negativo = (*p == '-');
+		p++;
+	}
 
-		// Se a linha atual é a do nome, le e pula a iteracao
-		if (!grafo_lido->nome) {
-			grafo_lido->nome = copia_str(linha);
-			continue;
+	if ((p < fim) && (*p >= '0') && (*p <= '9')) {
+		uint64_t valor = 0;
+		for (; (p < fim) && (*p >= '0') && (*p <= '9'); p++) {
+			uint64_t digito = (uint64_t) (*p - '0');
+			valor = (valor > (UINT64_MAX - digito) / 10) ? UINT64_MAX : valor * 10 + digito;
 		}
 
-		char nome_vertice1[MAX_LINHA], nome_vertice2[MAX_LINHA];
-		unsigned int peso = 1;
-		// Se é linha de aresta
-		if (sscanf(linha, "%s -- %s %u", nome_vertice1, nome_vertice2, &peso) >= 2) {
-			// Cria os dois vertices antes da atribuicao para evitar problemas com ponteiros
-			busca_ou_cria_vertice(grafo_lido, nome_vertice1);
-			busca_ou_cria_vertice(grafo_lido, nome_vertice2);
+		peso = (unsigned int) (negativo ? (0 - valor) : valor);
+	}
 
-			vertice *vertice1 = busca_ou_cria_vertice(grafo_lido, nome_vertice1);
-			vertice *vertice2 = busca_ou_cria_vertice(grafo_lido, nome_vertice2);
+	lida->nome1 = nome1;
+	lida->tamanho1 = tamanho1;
+	lida->nome2 = nome2;
+	lida->tamanho2 = tamanho2;
+	lida->peso = peso;
+	return LINHA_ARESTA;
+}
 
-			adiciona_aresta(vertice1, nome_vertice2, peso);
-			adiciona_aresta(vertice2, nome_vertice1, peso);		
-		} else { // Se é linha de definicao de vertice
-			busca_ou_cria_vertice(grafo_lido, linha);
+// Interpreta uma linha da entrada (sem o \n): a primeira linha nao ignorada e o nome do grafo
+// e as demais sao vertices ou arestas
+// Os nomes sao internados direto da linha, sem copias intermediarias
+void processa_linha(grafo *g, lista_arestas *lidas, const char *linha, size_t tamanho) {
+	linha_lida lida;
+	tipo_linha tipo = interpreta_linha(linha, tamanho, &lida);
+
+	if (tipo == LINHA_IGNORADA)
+		return;
+
+	// Se a linha atual é a do nome, guarda e termina
+	if (!g->nome) {
+		g->nome = copia_str(&g->nomes, linha, tamanho);
+		if (!g->nome) {
+			exit(-1);
 		}
+		return;
 	}
 
-	for (unsigned int i = 0; i < grafo_lido->num_vertices; i++) {
-		grafo_lido->num_arestas += grafo_lido->vertices[i].grau;
+	if (tipo == LINHA_VERTICE) {
+		busca_ou_cria_vertice(g, lida.nome1, lida.tamanho1);
+		return;
 	}
 
-	grafo_lido->num_arestas /= 2;
+	// Guarda os indices (e nao ponteiros), ja que a lista de vertices pode ser realocada
+	unsigned int indice1 = busca_ou_cria_vertice(g, lida.nome1, lida.tamanho1);
+	unsigned int indice2 = busca_ou_cria_vertice(g, lida.nome2, lida.tamanho2);
 
-	return grafo_lido;
+	adiciona_aresta(lidas, indice1, indice2, lida.peso);
 }
 
-// desaloca toda a estrutura de dados alocada em g
-unsigned int destroi_grafo(grafo *g) {
-	free(g->nome);
-	for (unsigned int i = 0; i < g->num_vertices; i++) {
-		free(g->vertices[i].nome);
-		for (unsigned int j = 0; j < g->vertices[i].grau; j++) {
-			free(g->vertices[i].arestas[j].nome_ponta);
+// Processa as linhas completas de bloco e retorna quantos bytes foram consumidos
+// Se fim_da_entrada, a ultima linha pode nao terminar em \n e o bloco e consumido inteiro
+// As quebras de linha sao achadas com memchr, que a biblioteca C implementa com instrucoes vetoriais
+size_t processa_bloco(grafo *g, lista_arestas *lidas, const char *bloco, size_t tamanho, unsigned int fim_da_entrada) {
+	const char *p = bloco;
+	const char *fim = bloco + tamanho;
+
+	while (p < fim) {
+		const char *quebra = (const char*) memchr(p, '\n', (size_t) (fim - p));
+
+		if (!quebra) {
+			if (!fim_da_entrada) {
+				break;
+			}
+			quebra = fim;
 		}
-		free(g->vertices[i].arestas);
+
+		processa_linha(g, lidas, p, (size_t) (quebra - p));
+		p = (quebra < fim) ? quebra + 1 : fim;
 	}
-	free(g->vertices);
-	free(g);
-	return 1;
-}
 
-// devolve o nome de g
-char *nome(grafo *g) {
-	return g->nome;
+	return (size_t) (p - bloco);
 }
 
-// devolve 1 se g é bipartido e 0 caso contrário
-unsigned int bipartido(grafo *g) {
-	if (g->num_vertices == 0) {
-		return 1;
-	}
+// Le o restante de f mapeando o arquivo em memoria
+// Retorna 1 se conseguiu e 0 se f nao e um arquivo comum que possa ser mapeado
+unsigned int le_arquivo_mapeado(FILE *f, grafo *g, lista_arestas *lidas) {
+	struct stat info;
+	int fd = fileno(f);
+	off_t posicao = ftello(f);
 
-	// cores[i] = cor do vertice g->vertices[i]
-	int *cores = (int*)malloc(sizeof(int) * g->num_vertices);
-	if (!cores) {
+	if ((fd < 0) || (posicao < 0) || (fstat(fd, &info) != 0) || (!S_ISREG(info.st_mode)) || (info.st_size <= posicao)) {
 		return 0;
 	}
 
-	// No inicio, nenhum vertice tem cor
-	for (unsigned int i = 0; i < g->num_vertices; i++) {
-		cores[i] = -1;
+	size_t tamanho = (size_t) info.st_size;
+	char *mapa = (char*) mmap(NULL, tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (mapa == MAP_FAILED) {
+		return 0;
 	}
 
-	// Cria a fila de vertices usada para a busca
-	unsigned int *fila = (unsigned int*)malloc(g->num_vertices * sizeof(unsigned int));
-	if (!fila) {
-		free(cores);
+	posix_madvise(mapa, tamanho, POSIX_MADV_SEQUENTIAL);
+	processa_bloco(g, lidas, mapa + posicao, tamanho - (size_t) posicao, 1);
+	munmap(mapa, tamanho);
+
+	// Deixa f como se tivesse sido lido ate o fim
+	fseeko(f, 0, SEEK_END);
+	return 1;
+}
+
+// Le o restante de f em blocos grandes (para pipes e terminais)
+// O trecho final de cada bloco, sem \n, passa para o inicio do bloco seguinte
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int le_em_blocos(FILE *f, grafo *g, lista_arestas *lidas) {
+	size_t capacidade = TAMANHO_BLOCO_LEITURA;
+	size_t usado = 0;
+	char *bloco = (char*) malloc(capacidade);
+	if (!bloco) {
 		return 0;
 	}
 
-	// Passa por todos os vertices, tentando pintar seus vizinhos com uma cor diferente da dele
-	// Se um vizinho ja esta pintado com a mesma cor da dele, retorna que o grafo nao é bipartido
-	for (unsigned int inicio = 0; inicio < g->num_vertices; inicio++) {
-		if (cores[inicio] != -1) {
-			continue;
+	while (1) {
+		// Uma linha maior que o bloco inteiro faz o bloco crescer
+		if (usado == capacidade) {
+			char *realocacao_bloco = realloc(bloco, 2 * capacidade);
+			if (!realocacao_bloco) {
+				free(bloco);
+				return 0;
+			}
+			bloco = realocacao_bloco;
+			capacidade *= 2;
 		}
 
-		unsigned int frente, tras;
-		frente = 0;
-		tras = 0;
-		fila[tras++] = inicio;
-		cores[inicio] = 0;
+		size_t lidos = fread(bloco + usado, 1, capacidade - usado, f);
+		usado += lidos;
 
-		while (frente < tras) {
-			unsigned int u = fila[frente++];
-			vertice *vert_u = &g->vertices[u];
+		unsigned int fim_da_entrada = (lidos == 0);
+		size_t consumidos = processa_bloco(g, lidas, bloco, usado, fim_da_entrada);
 
-			for (unsigned int j = 0; j < vert_u->grau; j++) {
-				char *nome_vizinho = vert_u->arestas[j].nome_ponta;
-				unsigned int indice_vizinho = indice_do_vertice(g, nome_vizinho);
+		memmove(bloco, bloco + consumidos, usado - consumidos);
+		usado -= consumidos;
 
-				if (cores[indice_vizinho] == -1) {
-					cores[indice_vizinho] = 1 - cores[u];
-					fila[tras++] = indice_vizinho;
-				} else if (cores[indice_vizinho] == cores[u]) {
-					free(cores);
-					free(fila);
-					return 0;
-				}
-			}
+		if (fim_da_entrada) {
+			break;
 		}
 	}
 
-	free(cores);
-	free(fila);
+	free(bloco);
 	return 1;
 }
 
-// devolve o número de vértices em g
-unsigned int n_vertices(grafo *g) {
-	return g->num_vertices;
-}
-
-// devolve o número de arestas em g
-unsigned int n_arestas(grafo *g) {
-	return g->num_arestas;
-}
-
-// devolve o número de componentes em g
-unsigned int n_componentes(grafo *g) {
-	if (g->num_vertices == 0) {
-		return 0;
+// Deixa o restante de f inteiro em memoria: arquivos comuns sao mapeados e o resto e lido em blocos
+// Retorna o inicio do restante e guarda seu tamanho; tamanho_mapa e o tamanho do mapeamento
+// (o restante comeca em retorno - (tamanho_mapa - tamanho)) ou 0 se a memoria foi alocada
+// Retorna NULL em caso de erro
+char *le_entrada_inteira(FILE *f, size_t *tamanho, size_t *tamanho_mapa) {
+	struct stat info;
+	int fd = fileno(f);
+	off_t posicao = ftello(f);
+
+	if ((fd >= 0) && (posicao >= 0) && (fstat(fd, &info) == 0) && (S_ISREG(info.st_mode)) && (info.st_size > posicao)) {
+		char *mapa = (char*) mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if (mapa != MAP_FAILED) {
+			fseeko(f, 0, SEEK_END);
+			*tamanho_mapa = (size_t) info.st_size;
+			*tamanho = (size_t) (info.st_size - posicao);
+			return mapa + posicao;
+		}
 	}
 
-	unsigned int *visitados = (unsigned int*) malloc(sizeof(unsigned int) * g->num_vertices);
-	if (!visitados)
-		return 0;
-
-	for (unsigned int i = 0; i < g->num_vertices; i++) {
-		visitados[i] = 0;
+	size_t capacidade = TAMANHO_BLOCO_LEITURA;
+	size_t usado = 0;
+	char *entrada = (char*) malloc(capacidade);
+	if (!entrada) {
+		return NULL;
 	}
 
-	unsigned int componentes = 0;
-
-	for (unsigned int i = 0; i < g->num_vertices; i++) {
-		if (!visitados[i]) {
-			componentes++;
-
-			unsigned int frente, tras;
-			frente = 0;
-			tras = 0;
-			unsigned int *fila = (unsigned int*)malloc(g->num_vertices * sizeof(unsigned int));
-
-			visitados[i] = 1;
-			fila[tras++] = i;
-
-			while (frente < tras) {
-				unsigned int u = fila[frente++];
-				vertice *vert_u = &g->vertices[u];
-
-				for (unsigned int j = 0; j < vert_u->grau; j++) {
-					char *nome_vizinho = vert_u->arestas[j].nome_ponta;
-					unsigned int indice_vizinho = indice_do_vertice(g, nome_vizinho);
-					
-					if ((indice_vizinho != UINT_MAX) && (!visitados[indice_vizinho])) {
-						visitados[indice_vizinho] = 1;
-						fila[tras++] = indice_vizinho;
-					}
-				}
+	while (1) {
+		if (usado == capacidade) {
+			char *realocacao_entrada = realloc(entrada, 2 * capacidade);
+			if (!realocacao_entrada) {
+				free(entrada);
+				return NULL;
 			}
-			free(fila);
+			entrada = realocacao_entrada;
+			capacidade *= 2;
+		}
+
+		size_t lidos = fread(entrada + usado, 1, capacidade - usado, f);
+		if (lidos == 0) {
+			break;
 		}
+		usado += lidos;
 	}
 
-	free(visitados);
-	return componentes;
+	*tamanho_mapa = 0;
+	*tamanho = usado;
+	return entrada;
 }
 
-// devolve uma "string" com os diâmetros dos componentes de g separados por brancos
-// em ordem não decrescente
-char *diametros(grafo *g) {
-	if (g->num_vertices == 0) {
-		char *resposta = malloc(1);
-		if (resposta) {
-			resposta[0] = '\0';
+// Registra nome na fatia da tabela compartilhada, guardando em primeira o menor par
+// (pedaco, indice local) ja visto
+// Retorna a posicao do nome em fatia->nomes ou UINT_MAX em caso de erro
+unsigned int registra_nome_compartilhado(fatia_nomes *fatia, const char *nome, size_t tamanho, unsigned int hash, uint64_t primeira) {
+	pthread_mutex_lock(&fatia->trava);
+
+	// Mantem a ocupacao da tabela em no maximo 1/2
+	if (2 * (fatia->num_nomes + 1) > fatia->capacidade_tabela) {
+		unsigned int nova_capacidade = fatia->capacidade_tabela ? 2 * fatia->capacidade_tabela : CAPACIDADE_HASH_INICIAL;
+		unsigned int *nova_tabela = (unsigned int*) malloc(sizeof(unsigned int) * nova_capacidade);
+		if (!nova_tabela) {
+			pthread_mutex_unlock(&fatia->trava);
+			return UINT_MAX;
 		}
-		return resposta; 
-	}
 
-	unsigned int *visitados = (unsigned int*) malloc(sizeof(unsigned int) * g->num_vertices);
-	unsigned int *diametros_componentes = (unsigned int*) malloc(sizeof(unsigned int) * g->num_vertices);
-	unsigned int num_componente = 0;
+		for (unsigned int i = 0; i < nova_capacidade; i++) {
+			nova_tabela[i] = HASH_VAZIO;
+		}
+		for (unsigned int i = 0; i < fatia->num_nomes; i++) {
+			unsigned int posicao = fatia->nomes[i].hash & (nova_capacidade - 1);
+			while (nova_tabela[posicao] != HASH_VAZIO) {
+				posicao = (posicao + 1) & (nova_capacidade - 1);
+			}
+			nova_tabela[posicao] = i;
+		}
 
-	if ((!visitados) || (!diametros_componentes)) {
-		free(visitados);
-		free(diametros_componentes);
-		return NULL;
+		free(fatia->tabela);
+		fatia->tabela = nova_tabela;
+		fatia->capacidade_tabela = nova_capacidade;
 	}
 
-	for (unsigned int i = 0; i < g->num_vertices; i++) {
-		visitados[i] = 0;
-	}
-	
-	unsigned int *fila = (unsigned int*) malloc(sizeof(unsigned int) * g->num_vertices);
-	if (!fila) {
-		free(visitados);
-		free(diametros_componentes);
-		return NULL;
-	}
+	unsigned int mascara = fatia->capacidade_tabela - 1;
+	unsigned int posicao = hash & mascara;
+	while (fatia->tabela[posicao] != HASH_VAZIO) {
+		nome_compartilhado *existente = &fatia->nomes[fatia->tabela[posicao]];
 
-	for (unsigned int i = 0; i < g->num_vertices; i++) {
-		if (visitados[i]) {
-			continue;
+		if ((existente->hash == hash) && (existente->tamanho == tamanho) && (memcmp(existente->nome, nome, tamanho) == 0)) {
+			if (primeira < existente->primeira) {
+				existente->primeira = primeira;
+			}
+
+			unsigned int entrada = fatia->tabela[posicao];
+			pthread_mutex_unlock(&fatia->trava);
+			return entrada;
 		}
 
-		unsigned int frente, tras;
-		frente = 0;
-		tras = 0;
-		unsigned int tamanho_componente = 0;
-		unsigned int *vertices_componente = (unsigned int*) malloc(sizeof(unsigned int) * g->num_vertices);
+		posicao = (posicao + 1) & mascara;
+	}
 
-		if (!vertices_componente) {
-			continue;
+	if (fatia->num_nomes == fatia->capacidade_nomes) {
+		unsigned int nova_capacidade = fatia->capacidade_nomes ? 2 * fatia->capacidade_nomes : 64;
+		nome_compartilhado *realocacao_nomes = realloc(fatia->nomes, sizeof(nome_compartilhado) * nova_capacidade);
+		if (!realocacao_nomes) {
+			pthread_mutex_unlock(&fatia->trava);
+			return UINT_MAX;
 		}
+		fatia->nomes = realocacao_nomes;
+		fatia->capacidade_nomes = nova_capacidade;
+	}
 
-		fila[tras++] = i;
-		visitados[i] = 1;
-		vertices_componente[tamanho_componente++] = i;
+	unsigned int entrada = fatia->num_nomes++;
+	fatia->nomes[entrada].nome = nome;
+	fatia->nomes[entrada].tamanho = tamanho;
+	fatia->nomes[entrada].hash = hash;
+	fatia->nomes[entrada].primeira = primeira;
+	fatia->nomes[entrada].indice = UINT_MAX;
+	fatia->tabela[posicao] = entrada;
 
-		while (frente < tras) {
-			unsigned int u = fila[frente++];
-			vertice *vert_u = &g->vertices[u];
+	pthread_mutex_unlock(&fatia->trava);
+	return entrada;
+}
 
-			for (unsigned int j = 0; j < vert_u->grau; j++) {
-				char *nome_vizinho = vert_u->arestas[j].nome_ponta;
-				unsigned int indice_vizinho = indice_do_vertice(g, nome_vizinho);
+// Retorna o indice local de nome no pedaco, criando-o (e registrando-o na tabela compartilhada)
+// se e a primeira vez que o pedaco o ve
+// Retorna UINT_MAX em caso de erro
+unsigned int interna_local(pedaco_entrada *pedaco, unsigned int id_pedaco, fatia_nomes *fatias, const char *nome, size_t tamanho) {
+	if (2 * (pedaco->num_nomes + 1) > pedaco->capacidade_tabela) {
+		unsigned int nova_capacidade = pedaco->capacidade_tabela ? 2 * pedaco->capacidade_tabela : CAPACIDADE_HASH_INICIAL;
+		unsigned int *nova_tabela = (unsigned int*) malloc(sizeof(unsigned int) * nova_capacidade);
+		nome_local *realocacao_nomes = realloc(pedaco->nomes, sizeof(nome_local) * (nova_capacidade / 2));
+		if ((!nova_tabela) || (!realocacao_nomes)) {
+			free(nova_tabela);
+			if (realocacao_nomes) {
+				pedaco->nomes = realocacao_nomes;
+			}
+			return UINT_MAX;
+		}
+		pedaco->nomes = realocacao_nomes;
+		pedaco->capacidade_nomes = nova_capacidade / 2;
 
-				if ((indice_vizinho != UINT_MAX) && (!visitados[indice_vizinho])) {
-					visitados[indice_vizinho] = 1;
-					fila[tras++] = indice_vizinho;
-					vertices_componente[tamanho_componente++] = indice_vizinho;
-				} 
+		for (unsigned int i = 0; i < nova_capacidade; i++) {
+			nova_tabela[i] = HASH_VAZIO;
+		}
+		for (unsigned int i = 0; i < pedaco->num_nomes; i++) {
+			unsigned int posicao = pedaco->nomes[i].hash & (nova_capacidade - 1);
+			while (nova_tabela[posicao] != HASH_VAZIO) {
+				posicao = (posicao + 1) & (nova_capacidade - 1);
 			}
+			nova_tabela[posicao] = i;
 		}
 
-		diametros_componentes[num_componente++] = diametro_componente(g, vertices_componente, tamanho_componente);
-		free(vertices_componente);
+		free(pedaco->tabela);
+		pedaco->tabela = nova_tabela;
+		pedaco->capacidade_tabela = nova_capacidade;
 	}
 
-	free(visitados);
-	free(fila);
-
-	qsort(diametros_componentes, num_componente, sizeof(unsigned int), compara_uint);
-	
-	char *resultado = NULL;
-	size_t tamanho_total = 0;
-
-	for (unsigned int i = 0; i < num_componente; i++) {
-		char buffer[20];
-		int tamanho = snprintf(buffer, sizeof(buffer), "%u", diametros_componentes[i]);
-	
-		if (tamanho > 0) {
-			char *novo_resultado = realloc(resultado, tamanho_total + (size_t)tamanho + 1 + (i > 0 ? 1 : 0));
-
-			if (!novo_resultado) {
-				free(resultado);
-				free(diametros_componentes);
-				return NULL;
-			}
+	unsigned int hash = hash_nome(nome, tamanho);
+	unsigned int mascara = pedaco->capacidade_tabela - 1;
+	unsigned int posicao = hash & mascara;
+	while (pedaco->tabela[posicao] != HASH_VAZIO) {
+		nome_local *existente = &pedaco->nomes[pedaco->tabela[posicao]];
 
-			resultado = novo_resultado;
+		if ((existente->hash == hash) && (existente->tamanho == tamanho) && (memcmp(existente->nome, nome, tamanho) == 0))
+			return pedaco->tabela[posicao];
 
-			if (i > 0) {
-				resultado[tamanho_total++] = ' ';
-			}
+		posicao = (posicao + 1) & mascara;
+	}
 
-			strcpy(resultado + tamanho_total, buffer);
-			tamanho_total += (size_t)tamanho;
-		}
+	// A fatia e escolhida pelos bits altos do hash; os baixos escolhem a posicao dentro dela
+	unsigned int indice = pedaco->num_nomes;
+	uint64_t primeira = ((uint64_t) id_pedaco << 32) | indice;
+	unsigned int entrada = registra_nome_compartilhado(&fatias[hash >> (32 - BITS_FATIAS_NOMES)], nome, tamanho, hash, primeira);
+	if (entrada == UINT_MAX) {
+		return UINT_MAX;
 	}
 
-	free(diametros_componentes);
-	return resultado ? resultado : copia_str("");
+	pedaco->nomes[indice].nome = nome;
+	pedaco->nomes[indice].tamanho = tamanho;
+	pedaco->nomes[indice].hash = hash;
+	pedaco->nomes[indice].entrada = entrada;
+	pedaco->tabela[posicao] = indice;
+	pedaco->num_nomes++;
+
+	return indice;
 }
 
-// devolve uma "string" com os nomes dos vértices de corte de g em
-// ordem alfabética, separados por brancos
-char *vertices_corte(grafo *g) {
-	if (g->num_vertices == 0) {
-		char *resposta = malloc(1);
-		if (resposta) {
-			resposta[0]= '\0';
+// Primeira fase da leitura paralela: cada thread interpreta as linhas do seu pedaco
+void trabalhador_leitura(void *contexto, unsigned int id_thread) {
+	contexto_leitura *ctx = (contexto_leitura*) contexto;
+	pedaco_entrada *pedaco = &ctx->pedacos[id_thread];
+	const char *p = pedaco->inicio;
+
+	while (p < pedaco->fim) {
+		const char *quebra = (const char*) memchr(p, '\n', (size_t) (pedaco->fim - p));
+		if (!quebra) {
+			quebra = pedaco->fim;
 		}
-		return resposta;
-	}
 
-	unsigned int *tempo_descoberta = (unsigned int *) malloc(sizeof(unsigned int) * g->num_vertices);
-	unsigned int *low = (unsigned int *) malloc(sizeof(unsigned int) * g->num_vertices);
-	int *pai = (int*) malloc(sizeof(int) * g->num_vertices);
-	unsigned int *eh_corte = (unsigned int*) malloc(sizeof(unsigned int) * g->num_vertices);
-	
-	if ((!tempo_descoberta) || (!low) || (!pai) || (!eh_corte)) {
-		free(tempo_descoberta);
-		free(low);
-		free(pai);
-		free(eh_corte);
-		return NULL;
-	}
+		linha_lida lida;
+		tipo_linha tipo = interpreta_linha(p, (size_t) (quebra - p), &lida);
+		p = (quebra < pedaco->fim) ? quebra + 1 : pedaco->fim;
+
+		if (tipo == LINHA_IGNORADA) {
+			continue;
+		}
+
+		unsigned int indice1 = interna_local(pedaco, id_thread, ctx->fatias, lida.nome1, lida.tamanho1);
+		unsigned int indice2 = (tipo == LINHA_ARESTA) ? interna_local(pedaco, id_thread, ctx->fatias, lida.nome2, lida.tamanho2) : 0;
+		if ((indice1 == UINT_MAX) || (indice2 == UINT_MAX)) {
+			__atomic_store_n(&ctx->erro, 1, __ATOMIC_RELAXED);
+			return;
+		}
+
+		if (tipo == LINHA_ARESTA) {
+			adiciona_aresta(&pedaco->arestas, indice1, indice2, lida.peso);
+		}
+	}
+}
+
+// Segunda fase: cada thread conta os nomes que aparecem pela primeira vez no seu pedaco
+void trabalhador_proprios(void *contexto, unsigned int id_thread) {
+	contexto_leitura *ctx = (contexto_leitura*) contexto;
+	pedaco_entrada *pedaco = &ctx->pedacos[id_thread];
+
+	pedaco->num_proprios = 0;
+	for (unsigned int i = 0; i < pedaco->num_nomes; i++) {
+		nome_local *local = &pedaco->nomes[i];
+		nome_compartilhado *compartilhado = &ctx->fatias[local->hash >> (32 - BITS_FATIAS_NOMES)].nomes[local->entrada];
+
+		if (compartilhado->primeira == (((uint64_t) id_thread << 32) | i)) {
+			pedaco->num_proprios++;
+		}
+	}
+}
+
+// Terceira fase: cada thread numera, na ordem em que aparecem, os nomes que sao seus,
+// a partir de primeiro_indice, e os poe em nomes_vertices
+void trabalhador_indices(void *contexto, unsigned int id_thread) {
+	contexto_leitura *ctx = (contexto_leitura*) contexto;
+	pedaco_entrada *pedaco = &ctx->pedacos[id_thread];
+	unsigned int proximo = pedaco->primeiro_indice;
+
+	for (unsigned int i = 0; i < pedaco->num_nomes; i++) {
+		nome_local *local = &pedaco->nomes[i];
+		nome_compartilhado *compartilhado = &ctx->fatias[local->hash >> (32 - BITS_FATIAS_NOMES)].nomes[local->entrada];
+
+		if (compartilhado->primeira == (((uint64_t) id_thread << 32) | i)) {
+			compartilhado->indice = proximo;
+			ctx->nomes_vertices[proximo++] = *local;
+		}
+	}
+}
+
+// Quarta fase: cada thread traduz os indices locais das suas arestas e as copia para
+// a lista final, a partir de primeira_aresta
+void trabalhador_arestas(void *contexto, unsigned int id_thread) {
+	contexto_leitura *ctx = (contexto_leitura*) contexto;
+	pedaco_entrada *pedaco = &ctx->pedacos[id_thread];
+	aresta *destino = ctx->arestas + pedaco->primeira_aresta;
+
+	for (unsigned int i = 0; i < pedaco->arestas.tamanho; i++) {
+		aresta *a = &pedaco->arestas.arestas[i];
+		nome_local *local_u = &pedaco->nomes[a->u];
+		nome_local *local_v = &pedaco->nomes[a->v];
+
+		destino[i].u = ctx->fatias[local_u->hash >> (32 - BITS_FATIAS_NOMES)].nomes[local_u->entrada].indice;
+		destino[i].v = ctx->fatias[local_v->hash >> (32 - BITS_FATIAS_NOMES)].nomes[local_v->entrada].indice;
+		destino[i].peso = a->peso;
+	}
+}
+
+// Desaloca os pedacos e a tabela compartilhada da leitura paralela
+void libera_leitura(contexto_leitura *ctx, unsigned int num_pedacos) {
+	if (ctx->pedacos) {
+		for (unsigned int i = 0; i < num_pedacos; i++) {
+			free(ctx->pedacos[i].nomes);
+			free(ctx->pedacos[i].tabela);
+			free(ctx->pedacos[i].arestas.arestas);
+		}
+	}
+
+	if (ctx->fatias) {
+		for (unsigned int i = 0; i < NUM_FATIAS_NOMES; i++) {
+			pthread_mutex_destroy(&ctx->fatias[i].trava);
+			free(ctx->fatias[i].nomes);
+			free(ctx->fatias[i].tabela);
+		}
+	}
+
+	free(ctx->pedacos);
+	free(ctx->fatias);
+	free(ctx->nomes_vertices);
+}
+
+// Aloca um grafo sem vertices nem arestas, com as configuracoes padrao
+grafo *cria_grafo_vazio(void) {
+	grafo *g = malloc(sizeof(grafo));
+	if (!g) {
+		return NULL;
+	}
+
+	g->nome = NULL;
+	g->num_vertices = 0;
+	g->num_arestas = 0;
+	g->vertices = NULL;
+	g->capacidade_vertices = 0;
+	memset(&g->nomes, 0, sizeof(arena));
+	ESTATISTICA(memset(&g->estatisticas, 0, sizeof(estatisticas_grafo));)
+	g->tabela_hash = NULL;
+	g->capacidade_hash = 0;
+	g->inicio_adj = NULL;
+	g->vizinhos = NULL;
+	g->pesos = NULL;
+	g->peso_minimo = 1;
+	g->peso_maximo = 1;
+	g->num_threads = 1;
+	g->modo_diametro = DIAMETRO_LIMITANTES;
+	g->versao = 0;
+	g->analise = NULL;
+	g->mapa = NULL;
+	g->tamanho_mapa = 0;
+	g->pendentes.arestas = NULL;
+	g->pendentes.tamanho = 0;
+	g->pendentes.capacidade = 0;
+	g->vertices_adj = 0;
+	g->conjuntos = NULL;
+	g->blocos = NULL;
+	g->posto_nome = NULL;
+	g->ordem_nomes = NULL;
+	g->vertices_postos = 0;
+
+	return g;
+}
+
+// Copia para memoria propria tudo o que um grafo carregado de imagem binaria usa direto do mapa
+// e desfaz o mapeamento, para que o grafo possa ser alterado
+// Retorna 1 em caso de sucesso e 0 em caso de erro (o grafo continua mapeado)
+unsigned int materializa_grafo(grafo *g) {
+	if (!g->mapa) {
+		return 1;
+	}
+
+	size_t n = g->num_vertices;
+	size_t total = g->inicio_adj[n];
+	unsigned int *tabela = (unsigned int*) malloc(sizeof(unsigned int) * (g->capacidade_hash ? g->capacidade_hash : 1));
+	unsigned int *inicio = (unsigned int*) malloc(sizeof(unsigned int) * (n + 1));
+	unsigned int *vizinhos = (unsigned int*) malloc(sizeof(unsigned int) * (total ? total : 1));
+	unsigned int *pesos = (unsigned int*) malloc(sizeof(unsigned int) * (total ? total : 1));
+
+	// Os nomes vao para a arena; se algo falhar, ela volta a ficar vazia e o grafo segue mapeado
+	char *nome_grafo = g->nome ? copia_str(&g->nomes, g->nome, strlen(g->nome)) : NULL;
+	unsigned int sucesso = (nome_grafo || !g->nome) && tabela && inicio && vizinhos && pesos;
+	char **nomes = sucesso ? (char**) malloc(sizeof(char*) * (n ? n : 1)) : NULL;
+
+	for (size_t i = 0; nomes && (i < n); i++) {
+		nomes[i] = copia_str(&g->nomes, g->vertices[i].nome, strlen(g->vertices[i].nome));
+		if (!nomes[i]) {
+			free(nomes);
+			nomes = NULL;
+		}
+	}
+
+	if (!nomes) {
+		libera_arena(&g->nomes);
+		free(tabela);
+		free(inicio);
+		free(vizinhos);
+		free(pesos);
+		return 0;
+	}
+
+	memcpy(tabela, g->tabela_hash, sizeof(unsigned int) * g->capacidade_hash);
+	memcpy(inicio, g->inicio_adj, sizeof(unsigned int) * (n + 1));
+	memcpy(vizinhos, g->vizinhos, sizeof(unsigned int) * total);
+	memcpy(pesos, g->pesos, sizeof(unsigned int) * total);
+	for (size_t i = 0; i < n; i++) {
+		g->vertices[i].nome = nomes[i];
+	}
+	free(nomes);
+
+	munmap(g->mapa, g->tamanho_mapa);
+	g->mapa = NULL;
+	g->tamanho_mapa = 0;
+	g->nome = nome_grafo;
+	g->tabela_hash = tabela;
+	g->inicio_adj = inicio;
+	g->vizinhos = vizinhos;
+	g->pesos = pesos;
+
+	return 1;
+}
+
+// Mistura os bits de x (finalizacao do MurmurHash3): cada bit de entrada muda cerca de
+// metade dos bits de saida, e a funcao e uma bijecao
+uint64_t mistura64(uint64_t x) {
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdull;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ull;
+	x ^= x >> 33;
+	return x;
+}
+
+// Acumula dados (tamanho multiplo de 8) no checksum da imagem binaria
+// Cada palavra de 64 bits entra por xor e o estado inteiro e misturado com mistura64; como cada
+// passo e uma bijecao do estado, mudar uma palavra sempre muda o resultado, e mudancas em
+// palavras diferentes so se cancelam por colisao do hash
+uint64_t atualiza_checksum(uint64_t checksum, const unsigned char *dados, size_t tamanho) {
+	for (size_t i = 0; i + 8 <= tamanho; i += 8) {
+		uint64_t palavra;
+		memcpy(&palavra, dados + i, 8);
+		checksum = mistura64(checksum ^ palavra);
+	}
+
+	return checksum;
+}
+
+// Checksum de uma imagem: o das secoes (checksum_secoes) continuado pelo cabecalho com o
+// campo checksum zerado
+uint64_t checksum_imagem(const cabecalho_binario *cab, uint64_t checksum_secoes) {
+	cabecalho_binario copia = *cab;
+	copia.checksum = 0;
+	return atualiza_checksum(checksum_secoes, (const unsigned char*) &copia, sizeof(copia));
+}
+
+// Escreve tamanho bytes na imagem binaria, atualizando checksum e posicao
+void escreve_bytes(escritor_binario *esc, const void *dados, size_t tamanho) {
+	const unsigned char *bytes = (const unsigned char*) dados;
+
+	if ((tamanho > 0) && (fwrite(bytes, 1, tamanho, esc->arquivo) != tamanho)) {
+		esc->erro = 1;
+		return;
+	}
+	esc->posicao += tamanho;
+
+	// Completa a palavra pendente, processa as palavras inteiras e guarda a sobra
+	size_t i = 0;
+	while ((esc->num_pendentes > 0) && (i < tamanho)) {
+		esc->pendente[esc->num_pendentes++] = bytes[i++];
+		if (esc->num_pendentes == 8) {
+			esc->checksum = atualiza_checksum(esc->checksum, esc->pendente, 8);
+			esc->num_pendentes = 0;
+		}
+	}
+
+	size_t inteiros = (tamanho - i) & ~(size_t) 7;
+	esc->checksum = atualiza_checksum(esc->checksum, bytes + i, inteiros);
+	i += inteiros;
+
+	while (i < tamanho) {
+		esc->pendente[esc->num_pendentes++] = bytes[i++];
+	}
+}
+
+// Completa a secao atual com zeros ate um multiplo de 8 bytes
+void alinha_secao(escritor_binario *esc) {
+	static const unsigned char zeros[8] = { 0 };
+
+	if (esc->posicao % 8 != 0) {
+		escreve_bytes(esc, zeros, (size_t) (8 - esc->posicao % 8));
+	}
+}
+
+// Retorna 1 se a secao [inicio, inicio + tamanho) cabe na imagem e comeca num multiplo de 8 bytes
+unsigned int secao_valida(const cabecalho_binario *cab, uint64_t inicio, uint64_t tamanho) {
+	return (inicio % 8 == 0) && (inicio >= sizeof(cabecalho_binario)) &&
+		(inicio <= cab->tamanho_total) && (tamanho <= cab->tamanho_total - inicio);
+}
+
+// Confere a estrutura de uma imagem binaria cujo cabecalho e limites de secoes ja foram validados,
+// em tempo O(V + E): nome do grafo e nomes dos vertices terminados dentro das suas secoes,
+// inicio_adj nao decrescente de 0 a 2 * num_arestas, vizinhos e entradas da tabela hash indices
+// validos (cada vertice exatamente uma vez na tabela) e peso_minimo e peso_maximo iguais aos
+// pesos extremos das arestas, ja que escolhem a estrategia de caminhos minimos
+// Retorna 1 se a imagem pode ser usada e 0 caso contrario
+unsigned int imagem_consistente(const cabecalho_binario *cab, const unsigned char *base) {
+	uint64_t n = cab->num_vertices;
+	uint64_t total_adj = 2 * (uint64_t) cab->num_arestas;
+
+	// As secoes de nomes vao ate a secao seguinte; o ultimo byte de cada uma e '\0' (o fim do
+	// ultimo nome ou o preenchimento), entao todo nome que comeca dentro dela termina dentro dela
+	if ((cab->secao_offsets_nomes <= cab->secao_nome) || (base[cab->secao_offsets_nomes - 1] != '\0') ||
+		(cab->secao_hashes < cab->secao_nomes)) {
+		return 0;
+	}
+
+	uint64_t tamanho_nomes = cab->secao_hashes - cab->secao_nomes;
+	if ((n > 0) && ((tamanho_nomes == 0) || (base[cab->secao_hashes - 1] != '\0'))) {
+		return 0;
+	}
+
+	const uint64_t *offsets_nomes = (const uint64_t*) (base + cab->secao_offsets_nomes);
+	for (uint64_t i = 0; i < n; i++) {
+		if (offsets_nomes[i] >= tamanho_nomes) {
+			return 0;
+		}
+	}
+
+	const uint32_t *inicio_adj = (const uint32_t*) (base + cab->secao_inicio_adj);
+	if ((inicio_adj[0] != 0) || (inicio_adj[n] != total_adj)) {
+		return 0;
+	}
+	for (uint64_t i = 0; i < n; i++) {
+		if (inicio_adj[i] > inicio_adj[i + 1]) {
+			return 0;
+		}
+	}
+
+	const uint32_t *vizinhos = (const uint32_t*) (base + cab->secao_vizinhos);
+	const uint32_t *pesos = (const uint32_t*) (base + cab->secao_pesos);
+	uint32_t peso_minimo = total_adj ? UINT32_MAX : 1;
+	uint32_t peso_maximo = total_adj ? 0 : 1;
+
+	for (uint64_t k = 0; k < total_adj; k++) {
+		if (vizinhos[k] >= n) {
+			return 0;
+		}
+		if (pesos[k] < peso_minimo)
+			peso_minimo = pesos[k];
+		if (pesos[k] > peso_maximo)
+			peso_maximo = pesos[k];
+	}
+
+	if ((cab->peso_minimo != peso_minimo) || (cab->peso_maximo != peso_maximo)) {
+		return 0;
+	}
+
+	// Cada vertice aparece uma unica vez na tabela; com capacidade_hash >= 2n, sobram posicoes
+	// vazias e toda sondagem termina
+	unsigned char *na_tabela = (unsigned char*) calloc(n ? n : 1, sizeof(unsigned char));
+	if (!na_tabela) {
+		return 0;
+	}
+
+	const uint32_t *tabela_hash = (const uint32_t*) (base + cab->secao_tabela_hash);
+	uint64_t ocupadas = 0;
+	unsigned int consistente = 1;
+
+	for (uint64_t i = 0; consistente && (i < cab->capacidade_hash); i++) {
+		if (tabela_hash[i] == HASH_VAZIO) {
+			continue;
+		}
+
+		consistente = (tabela_hash[i] < n) && (!na_tabela[tabela_hash[i]]);
+		if (consistente) {
+			na_tabela[tabela_hash[i]] = 1;
+			ocupadas++;
+		}
+	}
+
+	free(na_tabela);
+	return consistente && (ocupadas == n);
+}
+
+// Retorna o indice do vertice na lista de vertices do grafo g
+// Se vertice nao existe, retorna UINT_MAX
+unsigned int indice_do_vertice(grafo *g, const char *nome) {
+	if (g->num_vertices == 0) {
+		return UINT_MAX;
+	}
+
+	size_t tamanho = strlen(nome);
+	unsigned int posicao = busca_posicao_hash(g, nome, tamanho, hash_nome(nome, tamanho));
+	return g->tabela_hash[posicao];
+}
+
+// Aloca a memoria de trabalho do djikstra para o grafo g
+memoria_sssp *cria_memoria_sssp(grafo *g) {
+	memoria_sssp *mem = (memoria_sssp*) malloc(sizeof(memoria_sssp));
+	if (!mem) {
+		return NULL;
+	}
+
+	if ((g->peso_minimo == 1) && (g->peso_maximo == 1)) {
+		mem->modo = SSSP_BFS;
+	} else if (g->peso_maximo <= PESO_MAXIMO_BALDES) {
+		mem->modo = SSSP_BALDES;
+	} else {
+		mem->modo = SSSP_HEAP;
+	}
+
+	mem->distancias = (uint64_t*) malloc(sizeof(uint64_t) * g->num_vertices);
+	mem->alcancados = (unsigned int*) malloc(sizeof(unsigned int) * g->num_vertices);
+	mem->num_alcancados = 0;
+	mem->capacidade_heap = 64;
+	mem->tamanho_heap = 0;
+	mem->heap = (item_heap*) malloc(sizeof(item_heap) * mem->capacidade_heap);
+	mem->num_baldes = 0;
+	mem->baldes = NULL;
+	mem->prox_balde = NULL;
+	mem->ant_balde = NULL;
+
+	if ((!mem->distancias) || (!mem->alcancados) || (!mem->heap)) {
+		destroi_memoria_sssp(mem);
+		return NULL;
+	}
 
 	for (unsigned int i = 0; i < g->num_vertices; i++) {
-		tempo_descoberta[i] = UINT_MAX;
-		low[i] = UINT_MAX;
-		pai[i] = -1;
-		eh_corte[i] = 0;
+		mem->distancias[i] = DISTANCIA_INFINITA;
+	}
+	CONTA(bytes_alocados, (sizeof(uint64_t) + sizeof(unsigned int)) * g->num_vertices + sizeof(item_heap) * mem->capacidade_heap);
+
+	// Com pesos entre 0 e C, as distancias pendentes cabem numa janela de C+1 baldes circulares
+	if (mem->modo == SSSP_BALDES) {
+		mem->num_baldes = g->peso_maximo + 1;
+		mem->baldes = (unsigned int*) malloc(sizeof(unsigned int) * mem->num_baldes);
+		mem->prox_balde = (unsigned int*) malloc(sizeof(unsigned int) * g->num_vertices);
+		mem->ant_balde = (unsigned int*) malloc(sizeof(unsigned int) * g->num_vertices);
+
+		if ((!mem->baldes) || (!mem->prox_balde) || (!mem->ant_balde)) {
+			destroi_memoria_sssp(mem);
+			return NULL;
+		}
+
+		for (unsigned int i = 0; i < mem->num_baldes; i++) {
+			mem->baldes[i] = BALDE_VAZIO;
+		}
+		CONTA(bytes_alocados, sizeof(unsigned int) * (mem->num_baldes + 2 * (size_t) g->num_vertices));
+	}
+
+	return mem;
+}
+
+// Libera a memoria de trabalho do djikstra
+void destroi_memoria_sssp(memoria_sssp *mem) {
+	if (!mem) {
+		return;
+	}
+
+	free(mem->distancias);
+	free(mem->alcancados);
+	free(mem->heap);
+	free(mem->baldes);
+	free(mem->prox_balde);
+	free(mem->ant_balde);
+	free(mem);
+}
+
+// Insere (distancia, vertice) no heap minimo
+void insere_heap(memoria_sssp *mem, uint64_t distancia, unsigned int v) {
+	if (mem->tamanho_heap == mem->capacidade_heap) {
+		item_heap *realocacao_heap = realloc(mem->heap, 2 * mem->capacidade_heap * sizeof(item_heap));
+		if (!realocacao_heap) {
+			exit(-1);
+		}
+
+		mem->heap = realocacao_heap;
+		CONTA(bytes_alocados, mem->capacidade_heap * sizeof(item_heap));
+		mem->capacidade_heap *= 2;
+	}
+	CONTA(operacoes_fila, 1);
+
+	// Sobe o novo item enquanto ele for menor que o pai
+	size_t i = mem->tamanho_heap++;
+	while (i > 0) {
+		size_t pai = (i - 1) / 2;
+		if (mem->heap[pai].distancia <= distancia) {
+			break;
+		}
+
+		mem->heap[i] = mem->heap[pai];
+		i = pai;
+	}
+
+	mem->heap[i].distancia = distancia;
+	mem->heap[i].vertice = v;
+}
+
+// Remove e retorna o item de menor distancia do heap (que nao pode estar vazio)
+item_heap remove_min_heap(memoria_sssp *mem) {
+	CONTA(operacoes_fila, 1);
+	item_heap minimo = mem->heap[0];
+	item_heap ultimo = mem->heap[--mem->tamanho_heap];
+
+	// Desce o ultimo item a partir da raiz ate achar sua posicao
+	size_t i = 0;
+	while (2 * i + 1 < mem->tamanho_heap) {
+		size_t filho = 2 * i + 1;
+		if ((filho + 1 < mem->tamanho_heap) && (mem->heap[filho + 1].distancia < mem->heap[filho].distancia)) {
+			filho++;
+		}
+
+		if (ultimo.distancia <= mem->heap[filho].distancia) {
+			break;
+		}
+
+		mem->heap[i] = mem->heap[filho];
+		i = filho;
+	}
+
+	if (mem->tamanho_heap > 0) {
+		mem->heap[i] = ultimo;
+	}
+
+	return minimo;
+}
+
+// Restaura as distancias alteradas pela execucao anterior e poe origem a distancia 0
+void limpa_memoria_sssp(memoria_sssp *mem, unsigned int origem) {
+	for (unsigned int i = 0; i < mem->num_alcancados; i++) {
+		mem->distancias[mem->alcancados[i]] = DISTANCIA_INFINITA;
+	}
+	mem->num_alcancados = 0;
+	mem->tamanho_heap = 0;
+
+	// Distancia de um vertice para ele mesmo é 0
+	mem->distancias[origem] = 0;
+}
+
+// Busca em largura a partir de origem, para grafos em que todos os pesos sao 1
+// O proprio vetor alcancados serve de fila
+uint64_t bfs_sssp(grafo *g, unsigned int origem, memoria_sssp *mem) {
+	limpa_memoria_sssp(mem, origem);
+	mem->alcancados[mem->num_alcancados++] = origem;
+
+	for (unsigned int frente = 0; frente < mem->num_alcancados; frente++) {
+		unsigned int u = mem->alcancados[frente];
+		uint64_t nova_distancia = mem->distancias[u] + 1;
+		CONTA(arestas_examinadas, g->inicio_adj[u + 1] - g->inicio_adj[u]);
+
+		for (unsigned int j = g->inicio_adj[u]; j < g->inicio_adj[u + 1]; j++) {
+			unsigned int indice_vizinho = g->vizinhos[j];
+
+			if (mem->distancias[indice_vizinho] == DISTANCIA_INFINITA) {
+				mem->distancias[indice_vizinho] = nova_distancia;
+				mem->alcancados[mem->num_alcancados++] = indice_vizinho;
+			}
+		}
+	}
+
+	return mem->distancias[mem->alcancados[mem->num_alcancados - 1]];
+}
+
+// Poe v no balde correspondente a distancia
+void insere_balde(memoria_sssp *mem, unsigned int v, uint64_t distancia) {
+	CONTA(operacoes_fila, 1);
+	unsigned int balde = (unsigned int) (distancia % mem->num_baldes);
+
+	mem->ant_balde[v] = BALDE_VAZIO;
+	mem->prox_balde[v] = mem->baldes[balde];
+	if (mem->baldes[balde] != BALDE_VAZIO) {
+		mem->ant_balde[mem->baldes[balde]] = v;
+	}
+	mem->baldes[balde] = v;
+}
+
+// Tira v do balde correspondente a distancia
+void remove_balde(memoria_sssp *mem, unsigned int v, uint64_t distancia) {
+	CONTA(operacoes_fila, 1);
+	unsigned int balde = (unsigned int) (distancia % mem->num_baldes);
+
+	if (mem->ant_balde[v] != BALDE_VAZIO) {
+		mem->prox_balde[mem->ant_balde[v]] = mem->prox_balde[v];
+	} else {
+		mem->baldes[balde] = mem->prox_balde[v];
+	}
+
+	if (mem->prox_balde[v] != BALDE_VAZIO) {
+		mem->ant_balde[mem->prox_balde[v]] = mem->ant_balde[v];
+	}
+}
+
+// djikstra com fila de baldes (Dial), para pesos inteiros entre 0 e num_baldes-1
+// Os baldes sao esvaziados em ordem crescente de distancia, sem comparacoes entre vertices
+uint64_t djikstra_baldes(grafo *g, unsigned int origem, memoria_sssp *mem) {
+	limpa_memoria_sssp(mem, origem);
+	insere_balde(mem, origem, 0);
+
+	unsigned int pendentes = 1;
+	uint64_t distancia_atual = 0;
+	unsigned int balde = 0;
+
+	while (pendentes > 0) {
+		while (mem->baldes[balde] != BALDE_VAZIO) {
+			unsigned int u = mem->baldes[balde];
+			remove_balde(mem, u, distancia_atual);
+			pendentes--;
+
+			mem->alcancados[mem->num_alcancados++] = u;
+			CONTA(arestas_examinadas, g->inicio_adj[u + 1] - g->inicio_adj[u]);
+
+			for (unsigned int j = g->inicio_adj[u]; j < g->inicio_adj[u + 1]; j++) {
+				unsigned int indice_vizinho = g->vizinhos[j];
+				uint64_t nova_distancia = distancia_atual + g->pesos[j];
+
+				if (nova_distancia < mem->distancias[indice_vizinho]) {
+					if (mem->distancias[indice_vizinho] != DISTANCIA_INFINITA) {
+						remove_balde(mem, indice_vizinho, mem->distancias[indice_vizinho]);
+					} else {
+						pendentes++;
+					}
+
+					mem->distancias[indice_vizinho] = nova_distancia;
+					insere_balde(mem, indice_vizinho, nova_distancia);
+				}
+			}
+		}
+
+		if (pendentes > 0) {
+			distancia_atual++;
+			balde = (balde + 1 == mem->num_baldes) ? 0 : balde + 1;
+		}
+	}
+
+	return distancia_atual;
+}
+
+// djikstra com heap binario e remocao preguicosa, para pesos quaisquer
+uint64_t djikstra_heap(grafo *g, unsigned int origem, memoria_sssp *mem) {
+	limpa_memoria_sssp(mem, origem);
+	insere_heap(mem, 0, origem);
+
+	// Remocao preguicosa: cada vertice entra no heap a cada vez que sua distancia diminui
+	// e as entradas desatualizadas sao descartadas quando saem
+	uint64_t excentricidade = 0;
+	while (mem->tamanho_heap > 0) {
+		item_heap atual = remove_min_heap(mem);
+		unsigned int u = atual.vertice;
+
+		if (atual.distancia != mem->distancias[u]) {
+			continue;
+		}
+
+		mem->alcancados[mem->num_alcancados++] = u;
+		excentricidade = atual.distancia;
+		CONTA(arestas_examinadas, g->inicio_adj[u + 1] - g->inicio_adj[u]);
+
+		for (unsigned int j = g->inicio_adj[u]; j < g->inicio_adj[u + 1]; j++) {
+			unsigned int indice_vizinho = g->vizinhos[j];
+			uint64_t nova_distancia = atual.distancia + g->pesos[j];
+
+			if (nova_distancia < mem->distancias[indice_vizinho]) {
+				mem->distancias[indice_vizinho] = nova_distancia;
+				insere_heap(mem, nova_distancia, indice_vizinho);
+			}
+		}
+	}
+
+	return excentricidade;
+}
+
+// aplica djikstra a partir de origem, visitando apenas a componente de origem
+// ao final, mem->distancias tem a distancia de origem para cada vertice alcancado e
+// mem->alcancados tem esses vertices em ordem nao decrescente de distancia
+// retorna a excentricidade de origem (maior distancia a partir dela)
+uint64_t djikstra(grafo *g, unsigned int origem, memoria_sssp *mem) {
+	uint64_t excentricidade;
+
+	switch (mem->modo) {
+		case SSSP_BFS:
+			excentricidade = bfs_sssp(g, origem, mem);
+			break;
+		case SSSP_BALDES:
+			excentricidade = djikstra_baldes(g, origem, mem);
+			break;
+		default:
+			excentricidade = djikstra_heap(g, origem, mem);
+			break;
+	}
+
+	CONTA(execucoes_sssp, 1);
+	CONTA(vertices_visitados, mem->num_alcancados);
+	return excentricidade;
+}
+
+// Calcula o diametro de uma componente conexa
+uint64_t diametro_componente(grafo *g, unsigned int *vertices_componente, unsigned int tamanho_componente, memoria_sssp *mem) {
+	if ((tamanho_componente == 0) || (tamanho_componente == 1)) {
+		return 0;
+	}
+
+	uint64_t diametro = 0;
+	for (unsigned int i = 0; i < tamanho_componente; i++) {
+		uint64_t excentricidade = djikstra(g, vertices_componente[i], mem);
+
+		if (excentricidade > diametro) {
+			diametro = excentricidade;
+		}
+	}
+	return diametro;
+}
+
+// Aloca a memoria de trabalho da busca com varias origens para o grafo g
+// fronteira e proxima comecam vazias e cada execucao as deixa vazias ao terminar
+memoria_multipla *cria_memoria_multipla(grafo *g) {
+	memoria_multipla *mem = (memoria_multipla*) malloc(sizeof(memoria_multipla));
+	if (!mem) {
+		return NULL;
+	}
+
+	// Os conjuntos sao alinhados ao proprio tamanho, para as operacoes vetoriais
+	size_t num_posicoes = g->num_vertices ? g->num_vertices : 1;
+	size_t tamanho_conjuntos = sizeof(bits_origens) * num_posicoes;
+	void *visto = NULL;
+	void *fronteira = NULL;
+	void *proxima = NULL;
+
+	if (posix_memalign(&visto, sizeof(bits_origens), tamanho_conjuntos) != 0)
+		visto = NULL;
+	if (posix_memalign(&fronteira, sizeof(bits_origens), tamanho_conjuntos) != 0)
+		fronteira = NULL;
+	if (posix_memalign(&proxima, sizeof(bits_origens), tamanho_conjuntos) != 0)
+		proxima = NULL;
+
+	mem->visto = visto;
+	mem->fronteira = fronteira;
+	mem->proxima = proxima;
+	mem->lista = (unsigned int*) malloc(sizeof(unsigned int) * num_posicoes);
+	mem->proxima_lista = (unsigned int*) malloc(sizeof(unsigned int) * num_posicoes);
+	mem->marca = (unsigned char*) calloc(num_posicoes, 1);
+
+	if ((!mem->visto) || (!mem->fronteira) || (!mem->proxima) || (!mem->lista) || (!mem->proxima_lista) || (!mem->marca)) {
+		destroi_memoria_multipla(mem);
+		return NULL;
+	}
+
+	memset(mem->fronteira, 0, tamanho_conjuntos);
+	memset(mem->proxima, 0, tamanho_conjuntos);
+	CONTA(bytes_alocados, 3 * tamanho_conjuntos + (2 * sizeof(unsigned int) + 1) * num_posicoes);
+
+	return mem;
+}
+
+// Libera a memoria de trabalho da busca com varias origens
+void destroi_memoria_multipla(memoria_multipla *mem) {
+	if (!mem) {
+		return;
+	}
+
+	free(mem->visto);
+	free(mem->fronteira);
+	free(mem->proxima);
+	free(mem->lista);
+	free(mem->proxima_lista);
+	free(mem->marca);
+	free(mem);
+}
+
+// Retorna o OU das palavras de b (diferente de 0 se e so se b tem alguma origem)
+uint64_t algum_bit(bits_origens b) {
+	uint64_t alguma = 0;
+	for (unsigned int p = 0; p < PALAVRAS_MULTIPLA; p++) {
+		alguma |= b[p];
+	}
+	return alguma;
+}
+
+// Busca em largura a partir de num_origens (ate ORIGENS_MULTIPLA) origens distintas de uma mesma
+// componente ao mesmo tempo, para grafos com todos os pesos 1
+// Cada nivel empurra a fronteira de cada vertice da lista para os vizinhos, sem as origens que ja os
+// alcancaram: uma aresta examinada avanca todas as origens que chegaram juntas ao vertice
+// Retorna a maior excentricidade entre as origens (o ultimo nivel em que alguma origem alcanca
+// um vertice novo)
+uint64_t excentricidade_multipla(grafo *g, unsigned int *origens, unsigned int num_origens, unsigned int *vertices_componente, unsigned int tamanho_componente, memoria_multipla *mem) {
+	bits_origens vazio = { 0 };
+
+	for (unsigned int i = 0; i < tamanho_componente; i++) {
+		mem->visto[vertices_componente[i]] = vazio;
+	}
+
+	unsigned int tamanho_lista = 0;
+	for (unsigned int i = 0; i < num_origens; i++) {
+		unsigned int origem = origens[i];
+		mem->visto[origem][i / 64] |= (uint64_t) 1 << (i % 64);
+		mem->fronteira[origem] = mem->visto[origem];
+		mem->lista[tamanho_lista++] = origem;
+	}
+
+	uint64_t nivel = 0;
+	while (1) {
+		unsigned int tamanho_proxima = 0;
+		CONTA(vertices_visitados, tamanho_lista);
+
+		for (unsigned int k = 0; k < tamanho_lista; k++) {
+			unsigned int u = mem->lista[k];
+			bits_origens fronteira_u = mem->fronteira[u];
+			CONTA(arestas_examinadas, g->inicio_adj[u + 1] - g->inicio_adj[u]);
+
+			for (unsigned int j = g->inicio_adj[u]; j < g->inicio_adj[u + 1]; j++) {
+				unsigned int w = g->vizinhos[j];
+				bits_origens novas = fronteira_u & ~mem->visto[w];
+
+				if (algum_bit(novas)) {
+					if (!algum_bit(mem->proxima[w])) {
+						mem->proxima_lista[tamanho_proxima++] = w;
+					}
+					mem->proxima[w] |= novas;
+				}
+			}
+		}
+
+		for (unsigned int k = 0; k < tamanho_lista; k++) {
+			mem->fronteira[mem->lista[k]] = vazio;
+		}
+
+		if (tamanho_proxima == 0) {
+			break;
+		}
+
+		for (unsigned int k = 0; k < tamanho_proxima; k++) {
+			unsigned int w = mem->proxima_lista[k];
+			mem->visto[w] |= mem->proxima[w];
+			mem->fronteira[w] = mem->proxima[w];
+			mem->proxima[w] = vazio;
+		}
+
+		unsigned int *temp = mem->lista;
+		mem->lista = mem->proxima_lista;
+		mem->proxima_lista = temp;
+		tamanho_lista = tamanho_proxima;
+		nivel++;
+	}
+
+	CONTA(execucoes_sssp, num_origens);
+	return nivel;
+}
+
+// Poe em origens os num_candidatos candidatos (vertices de uma mesma componente) agrupados em lotes
+// de ORIGENS_MULTIPLA origens proximas entre si, que alcancam os demais vertices em niveis parecidos e
+// por isso dividem mais a fronteira: os lotes sao preenchidos por buscas em largura a partir dos
+// candidatos ainda sem lote, cada uma parada quando o lote enche, e cada candidato entra no lote ao
+// ser alcancado. Cada vertice e alcancado uma vez so, entao o agrupamento e linear
+// marca (1 = candidato sem lote, 2 = alcancado) deve vir zerada e volta zerada; fila precisa de uma
+// posicao por vertice da componente
+void agrupa_origens(grafo *g, unsigned int *candidatos, unsigned int num_candidatos, unsigned int *origens, unsigned char *marca, unsigned int *fila) {
+	for (unsigned int i = 0; i < num_candidatos; i++) {
+		marca[candidatos[i]] = 1;
+	}
+
+	unsigned int posicao = 0;
+	unsigned int alcancados = 0;
+	for (unsigned int k = 0; k < num_candidatos; k++) {
+		if (marca[candidatos[k]] != 1) {
+			continue;
+		}
+
+		unsigned int inicio_fila = alcancados;
+		marca[candidatos[k]] = 2;
+		fila[alcancados++] = candidatos[k];
+		origens[posicao++] = candidatos[k];
+
+		while ((inicio_fila < alcancados) && (posicao % ORIGENS_MULTIPLA != 0)) {
+			unsigned int u = fila[inicio_fila++];
+
+			for (unsigned int j = g->inicio_adj[u]; j < g->inicio_adj[u + 1]; j++) {
+				unsigned int w = g->vizinhos[j];
+				if (marca[w] == 2) {
+					continue;
+				}
+
+				unsigned int candidato = (marca[w] == 1);
+				marca[w] = 2;
+				fila[alcancados++] = w;
+				if (candidato) {
+					origens[posicao++] = w;
+					if (posicao % ORIGENS_MULTIPLA == 0) {
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	for (unsigned int i = 0; i < alcancados; i++) {
+		marca[fila[i]] = 0;
+	}
+}
+
+// Diz se, com os pesos todos 1, vale mais trocar as rodadas do metodo dos limitantes por buscas com
+// varias origens a partir de todos os candidatos restantes: as ultimas buscas (simples) descartaram
+// descartados candidatos, e as rodadas que faltam seriam cerca de candidatos / ritmo, contra
+// candidatos / ORIGENS_MULTIPLA lotes de CUSTO_LOTE_MULTIPLA buscas cada
+unsigned int vale_busca_multipla(unsigned int descartados, unsigned int buscas) {
+	return (uint64_t) descartados * CUSTO_LOTE_MULTIPLA < (uint64_t) buscas * ORIGENS_MULTIPLA;
+}
+
+// Maior excentricidade entre os num_candidatos primeiros de candidatos (os tamanho_componente vertices
+// de uma componente), por buscas com varias origens em lotes de vertices proximos
+// Os candidatos sao reagrupados no lugar, entre si
+uint64_t diametro_candidatos_multipla(grafo *g, unsigned int *candidatos, unsigned int num_candidatos, unsigned int tamanho_componente, memoria_multipla *mem) {
+	// lista e proxima_lista so sao usadas pela busca, entao servem aqui de fila e de destino
+	agrupa_origens(g, candidatos, num_candidatos, mem->proxima_lista, mem->marca, mem->lista);
+	memcpy(candidatos, mem->proxima_lista, sizeof(unsigned int) * num_candidatos);
+
+	uint64_t diametro = 0;
+	for (unsigned int i = 0; i < num_candidatos; i += ORIGENS_MULTIPLA) {
+		unsigned int num_origens = (num_candidatos - i < ORIGENS_MULTIPLA) ? num_candidatos - i : ORIGENS_MULTIPLA;
+		uint64_t excentricidade = excentricidade_multipla(g, candidatos + i, num_origens, candidatos, tamanho_componente, mem);
+
+		if (excentricidade > diametro) {
+			diametro = excentricidade;
+		}
+	}
+
+	return diametro;
+}
+
+// Escolhe, entre os candidatos, a proxima origem do metodo dos limitantes
+// busca_periferia = 1: maior limitante superior (tende a subir o limitante inferior do diametro)
+// busca_periferia = 0: menor limitante inferior (vertices centrais apertam os limitantes superiores)
+// Empates sao decididos pelo maior grau. Retorna a posicao do escolhido em candidatos
+unsigned int escolhe_candidato(grafo *g, unsigned int *candidatos, unsigned int num_candidatos, uint64_t *exc_inf, uint64_t *exc_sup, unsigned int busca_periferia) {
+	unsigned int escolhido = 0;
+
+	for (unsigned int i = 1; i < num_candidatos; i++) {
+		unsigned int w = candidatos[i];
+		unsigned int melhor = candidatos[escolhido];
+		unsigned int grau_w = g->inicio_adj[w + 1] - g->inicio_adj[w];
+		unsigned int grau_melhor = g->inicio_adj[melhor + 1] - g->inicio_adj[melhor];
+
+		uint64_t valor_w = busca_periferia ? exc_sup[w] : exc_inf[w];
+		uint64_t valor_melhor = busca_periferia ? exc_sup[melhor] : exc_inf[melhor];
+		unsigned int ganha = busca_periferia ? (valor_w > valor_melhor) : (valor_w < valor_melhor);
+
+		if (ganha || ((valor_w == valor_melhor) && (grau_w > grau_melhor))) {
+			escolhido = i;
+		}
+	}
+
+	return escolhido;
+}
+
+// Atualiza os limitantes dos num_candidatos candidatos com as distancias, em distancias, a partir de
+// uma origem de excentricidade excentricidade, e sobe *diametro_inf com os novos limitantes inferiores
+// Pela desigualdade triangular, max(d(v,w), exc(v) - d(v,w)) <= exc(w) <= exc(v) + d(v,w)
+void atualiza_limitantes(unsigned int *candidatos, unsigned int num_candidatos, uint64_t *distancias, uint64_t excentricidade, uint64_t *exc_inf, uint64_t *exc_sup, uint64_t *diametro_inf) {
+	for (unsigned int i = 0; i < num_candidatos; i++) {
+		unsigned int w = candidatos[i];
+		uint64_t d = distancias[w];
+		uint64_t inf = (excentricidade - d > d) ? excentricidade - d : d;
+		uint64_t sup = excentricidade + d;
+
+		if (inf > exc_inf[w])
+			exc_inf[w] = inf;
+		if (sup < exc_sup[w])
+			exc_sup[w] = sup;
+		if (exc_inf[w] > *diametro_inf)
+			*diametro_inf = exc_inf[w];
+	}
+}
+
+// Descarta (movendo para o fim de candidatos) quem nao pode aumentar o diametro, inclusive as
+// origens ja usadas, cujos limitantes coincidem. Retorna o novo numero de candidatos
+unsigned int descarta_candidatos(unsigned int *candidatos, unsigned int num_candidatos, uint64_t *exc_sup, uint64_t diametro_inf) {
+	for (unsigned int i = 0; i < num_candidatos; ) {
+		if (exc_sup[candidatos[i]] <= diametro_inf) {
+			unsigned int temp = candidatos[i];
+			candidatos[i] = candidatos[--num_candidatos];
+			candidatos[num_candidatos] = temp;
+		} else {
+			i++;
+		}
+	}
+
+	return num_candidatos;
+}
+
+// Calcula o diametro exato de uma componente conexa pelo metodo dos limitantes de excentricidade
+// (Takes e Kosters): um djikstra a partir de v fixa exc(v) e limita a excentricidade de todo w da
+// componente (veja atualiza_limitantes)
+// Vertices cuja excentricidade nao pode passar do maior limitante inferior ja conhecido sao descartados,
+// e o processo para quando nao ha mais candidatos. A primeira origem e o vertice de maior grau e a
+// segunda o mais distante dele (varredura dupla); depois alternam periferia e centro
+// Com mem_multipla (so se todos os pesos sao 1) e uma componente grande, quando o descarte de uma
+// janela de rodadas fica lento demais (veja vale_busca_multipla), os candidatos restantes passam
+// todos por buscas com varias origens; *mem_multipla e criada na primeira vez e fica para o chamador
+// candidatos (os vertices da componente) e reordenado; exc_inf e exc_sup sao indexados por vertice
+// Retorna DISTANCIA_INFINITA se faltou memoria para as buscas com varias origens
+uint64_t diametro_limitantes(grafo *g, unsigned int *candidatos, unsigned int tamanho_componente, memoria_sssp *mem, memoria_multipla **mem_multipla, uint64_t *exc_inf, uint64_t *exc_sup) {
+	if ((tamanho_componente == 0) || (tamanho_componente == 1)) {
+		return 0;
+	}
+
+	for (unsigned int i = 0; i < tamanho_componente; i++) {
+		exc_inf[candidatos[i]] = 0;
+		exc_sup[candidatos[i]] = DISTANCIA_INFINITA;
+	}
+
+	// Sem limitantes ainda, a escolha pelo maior limitante superior cai no desempate pelo grau
+	unsigned int num_candidatos = tamanho_componente;
+	unsigned int escolhido = escolhe_candidato(g, candidatos, num_candidatos, exc_inf, exc_sup, 1);
+	unsigned int busca_periferia = 1;
+	uint64_t diametro_inf = 0;
+	unsigned int troca_permitida = (mem_multipla) && (tamanho_componente >= MINIMO_VERTICES_MULTIPLA_LIMITANTES);
+	unsigned int rodadas_janela = 0;
+	unsigned int candidatos_janela = num_candidatos;
+
+	while (num_candidatos > 0) {
+		unsigned int origem = candidatos[escolhido];
+		uint64_t excentricidade = djikstra(g, origem, mem);
+
+		atualiza_limitantes(candidatos, num_candidatos, mem->distancias, excentricidade, exc_inf, exc_sup, &diametro_inf);
+		num_candidatos = descarta_candidatos(candidatos, num_candidatos, exc_sup, diametro_inf);
+
+		if ((troca_permitida) && (num_candidatos > 0) && (++rodadas_janela == JANELA_LIMITANTES)) {
+			if (vale_busca_multipla(candidatos_janela - num_candidatos, rodadas_janela)) {
+				if ((!*mem_multipla) && (!(*mem_multipla = cria_memoria_multipla(g)))) {
+					return DISTANCIA_INFINITA;
+				}
+
+				uint64_t diametro_restantes = diametro_candidatos_multipla(g, candidatos, num_candidatos, tamanho_componente, *mem_multipla);
+				return (diametro_restantes > diametro_inf) ? diametro_restantes : diametro_inf;
+			}
+
+			rodadas_janela = 0;
+			candidatos_janela = num_candidatos;
+		}
+
+		escolhido = escolhe_candidato(g, candidatos, num_candidatos, exc_inf, exc_sup, busca_periferia);
+		busca_periferia = !busca_periferia;
+	}
+
+	return diametro_inf;
+}
+
+// Trabalho de cada thread numa rodada de diametro_limitantes_paralelo: a thread id calcula a
+// excentricidade da origem id com sua propria memoria
+void trabalhador_rodada(void *contexto, unsigned int id_thread) {
+	contexto_rodada *ctx = (contexto_rodada*) contexto;
+
+	if (id_thread < ctx->num_origens) {
+		ctx->excentricidades[id_thread] = djikstra(ctx->g, ctx->origens[id_thread], ctx->mem[id_thread]);
+	}
+
+	ESTATISTICA(junta_contadores(ctx->g);)
+}
+
+// diametro_limitantes para uma componente grande, com num_threads threads: cada rodada escolhe ate
+// num_threads origens distintas (alternando periferia e centro, como as rodadas seguidas do metodo
+// sequencial), calcula suas excentricidades ao mesmo tempo e so entao junta os limitantes de todas
+// Com unitario (todos os pesos 1), a troca pelas buscas com varias origens segue a regra de
+// diametro_limitantes, e os lotes dos candidatos restantes sao repartidos entre as threads
+// Guarda o diametro em *diametro e retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int diametro_limitantes_paralelo(grafo *g, unsigned int *candidatos, unsigned int tamanho_componente, uint64_t *exc_inf, uint64_t *exc_sup, unsigned int num_threads, unsigned int unitario, uint64_t *diametro) {
+	memoria_sssp **mem = (memoria_sssp**) calloc(num_threads, sizeof(memoria_sssp*));
+	unsigned int *origens = (unsigned int*) malloc(sizeof(unsigned int) * num_threads);
+	uint64_t *excentricidades = (uint64_t*) malloc(sizeof(uint64_t) * num_threads);
+	unsigned int sucesso = (mem && origens && excentricidades);
+
+	for (unsigned int t = 0; sucesso && (t < num_threads); t++) {
+		mem[t] = cria_memoria_sssp(g);
+		sucesso = (mem[t] != NULL);
+	}
+
+	if (sucesso) {
+		for (unsigned int i = 0; i < tamanho_componente; i++) {
+			exc_inf[candidatos[i]] = 0;
+			exc_sup[candidatos[i]] = DISTANCIA_INFINITA;
+		}
+
+		unsigned int num_candidatos = tamanho_componente;
+		unsigned int busca_periferia = 1;
+		uint64_t diametro_inf = 0;
+		unsigned int buscas_janela = 0;
+		unsigned int candidatos_janela = num_candidatos;
+
+		while (num_candidatos > 0) {
+			// As origens escolhidas vao para o inicio de candidatos, fora das escolhas seguintes
+			unsigned int num_origens = 0;
+			while ((num_origens < num_threads) && (num_origens < num_candidatos)) {
+				unsigned int escolhido = num_origens + escolhe_candidato(g, candidatos + num_origens, num_candidatos - num_origens, exc_inf, exc_sup, busca_periferia);
+				unsigned int temp = candidatos[escolhido];
+				candidatos[escolhido] = candidatos[num_origens];
+				candidatos[num_origens] = temp;
+				origens[num_origens++] = temp;
+				busca_periferia = !busca_periferia;
+			}
+
+			contexto_rodada ctx = {
+				.g = g,
+				.origens = origens,
+				.mem = mem,
+				.excentricidades = excentricidades,
+				.num_origens = num_origens
+			};
+			executa_paralelo(num_origens, trabalhador_rodada, &ctx);
+
+			for (unsigned int t = 0; t < num_origens; t++) {
+				atualiza_limitantes(candidatos, num_candidatos, mem[t]->distancias, excentricidades[t], exc_inf, exc_sup, &diametro_inf);
+			}
+			num_candidatos = descarta_candidatos(candidatos, num_candidatos, exc_sup, diametro_inf);
+
+			buscas_janela += num_origens;
+			if ((unitario) && (num_candidatos > 0) && (buscas_janela >= JANELA_LIMITANTES * num_threads)) {
+				if (vale_busca_multipla(candidatos_janela - num_candidatos, buscas_janela)) {
+					sucesso = diametro_candidatos_paralelo(g, candidatos, num_candidatos, tamanho_componente, num_threads, &diametro_inf);
+					break;
+				}
+
+				buscas_janela = 0;
+				candidatos_janela = num_candidatos;
+			}
+		}
+
+		*diametro = diametro_inf;
+	}
+
+	for (unsigned int t = 0; mem && (t < num_threads); t++) {
+		destroi_memoria_sssp(mem[t]);
+	}
+	free(mem);
+	free(origens);
+	free(excentricidades);
+	return sucesso;
+}
+
+// Eleva *diametro a maior excentricidade entre os num_candidatos primeiros de candidatos (os
+// tamanho_componente vertices de uma componente), com os lotes de diametro_candidatos_multipla
+// repartidos entre num_threads threads. Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int diametro_candidatos_paralelo(grafo *g, unsigned int *candidatos, unsigned int num_candidatos, unsigned int tamanho_componente, unsigned int num_threads, uint64_t *diametro) {
+	unsigned int num_lotes = (num_candidatos + ORIGENS_MULTIPLA - 1) / ORIGENS_MULTIPLA;
+	unsigned int *inicio_lote = (unsigned int*) malloc(sizeof(unsigned int) * num_lotes);
+	unsigned int *componente_lote = (unsigned int*) calloc(num_lotes, sizeof(unsigned int));
+	unsigned int *origens = (unsigned int*) malloc(sizeof(unsigned int) * num_candidatos);
+	unsigned int *fila = (unsigned int*) malloc(sizeof(unsigned int) * tamanho_componente);
+	unsigned char *marca = (unsigned char*) calloc(g->num_vertices, 1);
+
+	if ((!inicio_lote) || (!componente_lote) || (!origens) || (!fila) || (!marca)) {
+		free(inicio_lote);
+		free(componente_lote);
+		free(origens);
+		free(fila);
+		free(marca);
+		return 0;
+	}
+
+	agrupa_origens(g, candidatos, num_candidatos, origens, marca, fila);
+	free(fila);
+	free(marca);
+	for (unsigned int i = 0; i < num_lotes; i++) {
+		inicio_lote[i] = i * ORIGENS_MULTIPLA;
+	}
+
+	// Uma componente so, com todos os vertices em candidatos
+	unsigned int inicio_componente[2] = { 0, tamanho_componente };
+	contexto_multipla ctx = {
+		.g = g,
+		.ordem = candidatos,
+		.origens = origens,
+		.inicio_componente = inicio_componente,
+		.fim_origens = &num_candidatos,
+		.inicio_lote = inicio_lote,
+		.componente_lote = componente_lote,
+		.diametros = diametro,
+		.num_tarefas = num_lotes,
+		.proxima_tarefa = 0,
+		.erro = 0
+	};
+
+	executa_paralelo(num_threads < num_lotes ? num_threads : num_lotes, trabalhador_multipla, &ctx);
+
+	free(inicio_lote);
+	free(componente_lote);
+	free(origens);
+	return !ctx.erro;
+}
+
+// Numero de threads que as funcoes de g devem usar (0 = numero de processadores disponiveis)
+unsigned int threads_efetivas(grafo *g) {
+	if (g->num_threads > 0) {
+		return g->num_threads;
+	}
+
+	long processadores = sysconf(_SC_NPROCESSORS_ONLN);
+	return (processadores > 0) ? (unsigned int) processadores : 1;
+}
+
+// Ponto de entrada das threads criadas por executa_em_threads_novas
+void *inicia_thread(void *arg) {
+	argumento_thread *argumento = (argumento_thread*) arg;
+	argumento->funcao(argumento->contexto, argumento->id_thread);
+	return NULL;
+}
+
+// Executa funcao(contexto, id) para id = 0 .. num_threads-1, criando uma thread para cada id
+// a partir de 1 e juntando-as no fim; a thread chamadora executa o id 0
+// Se nao for possivel criar alguma thread, o id correspondente e executado pela chamadora
+void executa_em_threads_novas(unsigned int num_threads, void (*funcao)(void *, unsigned int), void *contexto) {
+	pthread_t *threads = (pthread_t*) malloc(sizeof(pthread_t) * num_threads);
+	argumento_thread *argumentos = (argumento_thread*) malloc(sizeof(argumento_thread) * num_threads);
+	unsigned int *criada = (unsigned int*) calloc(num_threads, sizeof(unsigned int));
+
+	if ((!threads) || (!argumentos) || (!criada)) {
+		free(threads);
+		free(argumentos);
+		free(criada);
+
+		for (unsigned int i = 0; i < num_threads; i++) {
+			funcao(contexto, i);
+		}
+		return;
+	}
+
+	for (unsigned int i = 1; i < num_threads; i++) {
+		argumentos[i].funcao = funcao;
+		argumentos[i].contexto = contexto;
+		argumentos[i].id_thread = i;
+		criada[i] = (pthread_create(&threads[i], NULL, inicia_thread, &argumentos[i]) == 0);
+	}
+
+	funcao(contexto, 0);
+
+	for (unsigned int i = 1; i < num_threads; i++) {
+		if (criada[i]) {
+			pthread_join(threads[i], NULL);
+		} else {
+			funcao(contexto, i);
+		}
+	}
+
+	free(threads);
+	free(argumentos);
+	free(criada);
+}
+
+// Laco de cada auxiliar da reserva: espera cada nova geracao e, se tem um id nela, executa-o
+// As auxiliares nunca terminam; ficam bloqueadas em tem_trabalho entre as chamadas
+void *trabalha_na_reserva(void *arg) {
+	argumento_auxiliar *argumento = (argumento_auxiliar*) arg;
+	unsigned int indice = argumento->indice;
+	unsigned int vista = argumento->geracao;
+	free(argumento);
+
+	pthread_mutex_lock(&reserva.trava);
+	while (1) {
+		while (reserva.geracao == vista) {
+			pthread_cond_wait(&reserva.tem_trabalho, &reserva.trava);
+		}
+		vista = reserva.geracao;
+
+		if (indice + 1 < reserva.num_ids) {
+			void (*funcao)(void *, unsigned int) = reserva.funcao;
+			void *contexto = reserva.contexto;
+
+			pthread_mutex_unlock(&reserva.trava);
+			funcao(contexto, indice + 1);
+			pthread_mutex_lock(&reserva.trava);
+
+			if (--reserva.pendentes == 0) {
+				pthread_cond_signal(&reserva.terminou);
+			}
+		}
+	}
+
+	return NULL;
+}
+
+// Num processo filho criado por fork so existe a thread que o chamou: a reserva volta a ficar
+// vazia e destravada
+void esvazia_reserva_no_filho(void) {
+	pthread_mutex_init(&reserva.uso, NULL);
+	pthread_mutex_init(&reserva.trava, NULL);
+	pthread_cond_init(&reserva.tem_trabalho, NULL);
+	pthread_cond_init(&reserva.terminou, NULL);
+	reserva.num_auxiliares = 0;
+	reserva.pendentes = 0;
+}
+
+// Executada uma vez por processo antes do primeiro uso da reserva
+void registra_reserva(void) {
+	pthread_atfork(NULL, NULL, esvazia_reserva_no_filho);
+}
+
+// Cria auxiliares ate a reserva ter quantidade delas (ou MAXIMO_AUXILIARES), enquanto for possivel
+// Deve ser chamada com reserva.trava travada
+void aumenta_reserva(unsigned int quantidade) {
+	pthread_attr_t atributos;
+	if (pthread_attr_init(&atributos) != 0) {
+		return;
+	}
+	pthread_attr_setdetachstate(&atributos, PTHREAD_CREATE_DETACHED);
+
+	while ((reserva.num_auxiliares < quantidade) && (reserva.num_auxiliares < MAXIMO_AUXILIARES)) {
+		argumento_auxiliar *argumento = (argumento_auxiliar*) malloc(sizeof(argumento_auxiliar));
+		if (!argumento) {
+			break;
+		}
+
+		// A auxiliar so atende geracoes posteriores a sua criacao
+		argumento->indice = reserva.num_auxiliares;
+		argumento->geracao = reserva.geracao;
+
+		pthread_t thread;
+		if (pthread_create(&thread, &atributos, trabalha_na_reserva, argumento) != 0) {
+			free(argumento);
+			break;
+		}
+		reserva.num_auxiliares++;
+	}
+
+	pthread_attr_destroy(&atributos);
+}
+
+// Executa funcao(contexto, id) para id = 0 .. num_threads-1, cada uma numa thread
+// A thread chamadora executa o id 0 e os demais vao para as auxiliares da reserva, criadas na
+// primeira vez em que sao necessarias e reaproveitadas depois; os ids que nao cabem nas auxiliares
+// sao executados pela chamadora. Se a reserva ja estiver em uso por outra thread do programa, as
+// threads sao criadas so para esta chamada
+void executa_paralelo(unsigned int num_threads, void (*funcao)(void *, unsigned int), void *contexto) {
+	if (num_threads <= 1) {
+		funcao(contexto, 0);
+		return;
+	}
+
+	pthread_once(&reserva_registrada, registra_reserva);
+	if (pthread_mutex_trylock(&reserva.uso) != 0) {
+		executa_em_threads_novas(num_threads, funcao, contexto);
+		return;
+	}
+
+	pthread_mutex_lock(&reserva.trava);
+	aumenta_reserva(num_threads - 1);
+
+	unsigned int participantes = (num_threads - 1 < reserva.num_auxiliares) ? num_threads - 1 : reserva.num_auxiliares;
+	reserva.funcao = funcao;
+	reserva.contexto = contexto;
+	reserva.num_ids = participantes + 1;
+	reserva.pendentes = participantes;
+	reserva.geracao++;
+	pthread_cond_broadcast(&reserva.tem_trabalho);
+	pthread_mutex_unlock(&reserva.trava);
+
+	funcao(contexto, 0);
+	for (unsigned int i = participantes + 1; i < num_threads; i++) {
+		funcao(contexto, i);
+	}
+
+	pthread_mutex_lock(&reserva.trava);
+	while (reserva.pendentes > 0) {
+		pthread_cond_wait(&reserva.terminou, &reserva.trava);
+	}
+	pthread_mutex_unlock(&reserva.trava);
+
+	pthread_mutex_unlock(&reserva.uso);
+}
+
+// Faz *destino = max(*destino, valor) sem travas
+void maximo_atomico(uint64_t *destino, uint64_t valor) {
+	uint64_t atual = __atomic_load_n(destino, __ATOMIC_RELAXED);
+
+	while ((valor > atual) && (!__atomic_compare_exchange_n(destino, &atual, valor, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))) {
+		// Em caso de falha, atual recebe o valor corrente de *destino e a comparacao e refeita
+	}
+}
+
+// Trabalho de cada thread: enquanto houver origens livres, pega a proxima e calcula sua excentricidade
+// Cada thread tem sua propria memoria de djikstra
+void trabalhador_excentricidades(void *contexto, unsigned int id_thread) {
+	contexto_excentricidades *ctx = (contexto_excentricidades*) contexto;
+	(void) id_thread;
+
+	memoria_sssp *mem = cria_memoria_sssp(ctx->g);
+	if (!mem) {
+		__atomic_store_n(&ctx->erro, 1, __ATOMIC_RELAXED);
+		return;
+	}
+
+	while (1) {
+		unsigned int tarefa = __atomic_fetch_add(&ctx->proxima_tarefa, 1, __ATOMIC_RELAXED);
+		if (tarefa >= ctx->num_tarefas) {
+			break;
+		}
+
+		unsigned int origem = ctx->ordem[tarefa];
+		uint64_t excentricidade = djikstra(ctx->g, origem, mem);
+		maximo_atomico(&ctx->diametros[ctx->componente[origem]], excentricidade);
+	}
+
+	destroi_memoria_sssp(mem);
+	ESTATISTICA(junta_contadores(ctx->g);)
+}
+
+// Calcula, com num_threads threads, o diametro de cada componente como a maior excentricidade
+// entre seus vertices. diametros_componentes deve vir zerado
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int excentricidades_paralelas(grafo *g, unsigned int *ordem, unsigned int *componente, uint64_t *diametros_componentes, unsigned int num_threads) {
+	contexto_excentricidades ctx = {
+		.g = g,
+		.ordem = ordem,
+		.componente = componente,
+		.diametros = diametros_componentes,
+		.num_tarefas = g->num_vertices,
+		.proxima_tarefa = 0,
+		.erro = 0
+	};
+
+	executa_paralelo(num_threads, trabalhador_excentricidades, &ctx);
+
+	return !ctx.erro;
+}
+
+// Trabalho de cada thread: enquanto houver lotes livres, pega o proximo e reduz a maior
+// excentricidade das suas origens no diametro da componente
+void trabalhador_multipla(void *contexto, unsigned int id_thread) {
+	contexto_multipla *ctx = (contexto_multipla*) contexto;
+	(void) id_thread;
+
+	memoria_multipla *mem = cria_memoria_multipla(ctx->g);
+	if (!mem) {
+		__atomic_store_n(&ctx->erro, 1, __ATOMIC_RELAXED);
+		return;
+	}
+
+	while (1) {
+		unsigned int tarefa = __atomic_fetch_add(&ctx->proxima_tarefa, 1, __ATOMIC_RELAXED);
+		if (tarefa >= ctx->num_tarefas) {
+			break;
+		}
+
+		unsigned int c = ctx->componente_lote[tarefa];
+		unsigned int inicio = ctx->inicio_componente[c];
+		unsigned int fim = ctx->inicio_componente[c + 1];
+		unsigned int primeira = ctx->inicio_lote[tarefa];
+		unsigned int fim_origens = ctx->fim_origens[c];
+		unsigned int num_origens = (fim_origens - primeira < ORIGENS_MULTIPLA) ? fim_origens - primeira : ORIGENS_MULTIPLA;
+
+		uint64_t excentricidade = excentricidade_multipla(ctx->g, ctx->origens + primeira, num_origens, ctx->ordem + inicio, fim - inicio, mem);
+		maximo_atomico(&ctx->diametros[c], excentricidade);
+	}
+
+	destroi_memoria_multipla(mem);
+	ESTATISTICA(junta_contadores(ctx->g);)
+}
+
+// Calcula o diametro de cada componente como a maior excentricidade entre seus vertices, com buscas
+// em largura de ORIGENS_MULTIPLA origens por vez (so vale se todos os pesos sao 1)
+// Os lotes de origens sao repartidos entre num_threads threads; componentes com um vertice so
+// ficam com diametro 0. diametros_componentes deve vir zerado
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int diametros_multiplos(grafo *g, unsigned int *ordem, unsigned int *inicio_componente, unsigned int num_componentes, uint64_t *diametros_componentes, unsigned int num_threads) {
+	unsigned int num_lotes = 0;
+	for (unsigned int c = 0; c < num_componentes; c++) {
+		unsigned int tamanho_componente = inicio_componente[c + 1] - inicio_componente[c];
+		if (tamanho_componente > 1) {
+			num_lotes += (tamanho_componente + ORIGENS_MULTIPLA - 1) / ORIGENS_MULTIPLA;
+		}
+	}
+
+	if (num_lotes == 0) {
+		return 1;
+	}
+
+	unsigned int *inicio_lote = (unsigned int*) malloc(sizeof(unsigned int) * num_lotes);
+	unsigned int *componente_lote = (unsigned int*) malloc(sizeof(unsigned int) * num_lotes);
+	unsigned int *origens = (unsigned int*) malloc(sizeof(unsigned int) * g->num_vertices);
+	unsigned int *fila = (unsigned int*) malloc(sizeof(unsigned int) * g->num_vertices);
+	unsigned char *marca = (unsigned char*) calloc(g->num_vertices, sizeof(unsigned char));
+
+	if ((!inicio_lote) || (!componente_lote) || (!origens) || (!fila) || (!marca)) {
+		free(inicio_lote);
+		free(componente_lote);
+		free(origens);
+		free(fila);
+		free(marca);
+		return 0;
+	}
+
+	// Todos os vertices de cada componente sao origens, em lotes de vertices proximos
+	unsigned int lote = 0;
+	for (unsigned int c = 0; c < num_componentes; c++) {
+		unsigned int inicio = inicio_componente[c];
+		unsigned int fim = inicio_componente[c + 1];
+		if (fim - inicio <= 1) {
+			continue;
+		}
+
+		agrupa_origens(g, ordem + inicio, fim - inicio, origens + inicio, marca, fila);
+		for (unsigned int i = inicio; i < fim; i += ORIGENS_MULTIPLA) {
+			inicio_lote[lote] = i;
+			componente_lote[lote] = c;
+			lote++;
+		}
+	}
+	free(fila);
+	free(marca);
+
+	contexto_multipla ctx = {
+		.g = g,
+		.ordem = ordem,
+		.origens = origens,
+		.inicio_componente = inicio_componente,
+		.fim_origens = inicio_componente + 1,
+		.inicio_lote = inicio_lote,
+		.componente_lote = componente_lote,
+		.diametros = diametros_componentes,
+		.num_tarefas = num_lotes,
+		.proxima_tarefa = 0,
+		.erro = 0
+	};
+
+	executa_paralelo(num_threads < num_lotes ? num_threads : num_lotes, trabalhador_multipla, &ctx);
+
+	free(inicio_lote);
+	free(componente_lote);
+	free(origens);
+	return !ctx.erro;
+}
+
+// Trabalho de cada thread: enquanto houver componentes livres, pega a proxima e calcula seu diametro
+void trabalhador_limitantes(void *contexto, unsigned int id_thread) {
+	contexto_limitantes *ctx = (contexto_limitantes*) contexto;
+	(void) id_thread;
+
+	memoria_sssp *mem = cria_memoria_sssp(ctx->g);
+	memoria_multipla *mem_multipla = NULL;
+	if (!mem) {
+		__atomic_store_n(&ctx->erro, 1, __ATOMIC_RELAXED);
+		return;
+	}
+
+	while (1) {
+		unsigned int c = __atomic_fetch_add(&ctx->proxima_componente, 1, __ATOMIC_RELAXED);
+		if (c >= ctx->num_componentes) {
+			break;
+		}
+
+		unsigned int tamanho_componente = ctx->inicio_componente[c + 1] - ctx->inicio_componente[c];
+		if (tamanho_componente >= ctx->tamanho_grande) {
+			continue;
+		}
+		ctx->diametros[c] = diametro_limitantes(ctx->g, ctx->ordem + ctx->inicio_componente[c], tamanho_componente, mem, ctx->unitario ? &mem_multipla : NULL, ctx->exc_inf, ctx->exc_sup);
+		if (ctx->diametros[c] == DISTANCIA_INFINITA) {
+			__atomic_store_n(&ctx->erro, 1, __ATOMIC_RELAXED);
+			break;
+		}
+	}
+
+	destroi_memoria_sssp(mem);
+	destroi_memoria_multipla(mem_multipla);
+	ESTATISTICA(junta_contadores(ctx->g);)
+}
+
+// Calcula o diametro de cada componente pelo metodo dos limitantes, com num_threads threads:
+// cada componente grande (de MINIMO_VERTICES_LIMITANTES_PARALELOS vertices ou mais) usa todas as
+// threads em cada rodada, e as demais sao repartidas entre as threads
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int diametros_por_limitantes(grafo *g, unsigned int *ordem, unsigned int *inicio_componente, unsigned int num_componentes, uint64_t *diametros_componentes, unsigned int num_threads) {
+	// O metodo dos limitantes reordena os candidatos, entao trabalha numa copia de ordem
+	uint64_t *exc_inf = (uint64_t*) malloc(sizeof(uint64_t) * g->num_vertices);
+	uint64_t *exc_sup = (uint64_t*) malloc(sizeof(uint64_t) * g->num_vertices);
+	unsigned int *candidatos = (unsigned int*) malloc(sizeof(unsigned int) * g->num_vertices);
+
+	if ((!exc_inf) || (!exc_sup) || (!candidatos)) {
+		free(exc_inf);
+		free(exc_sup);
+		free(candidatos);
+		return 0;
+	}
+
+	memcpy(candidatos, ordem, sizeof(unsigned int) * g->num_vertices);
+
+	unsigned int tamanho_grande = (num_threads > 1) ? MINIMO_VERTICES_LIMITANTES_PARALELOS : UINT_MAX;
+	unsigned int unitario = (g->peso_minimo == 1) && (g->peso_maximo == 1);
+	unsigned int sucesso = 1;
+
+	for (unsigned int c = 0; sucesso && (c < num_componentes); c++) {
+		unsigned int tamanho_componente = inicio_componente[c + 1] - inicio_componente[c];
+		if (tamanho_componente >= tamanho_grande) {
+			sucesso = diametro_limitantes_paralelo(g, candidatos + inicio_componente[c], tamanho_componente, exc_inf, exc_sup, num_threads, unitario, &diametros_componentes[c]);
+		}
+	}
+
+	contexto_limitantes ctx = {
+		.g = g,
+		.ordem = candidatos,
+		.inicio_componente = inicio_componente,
+		.num_componentes = num_componentes,
+		.tamanho_grande = tamanho_grande,
+		.unitario = unitario,
+		.diametros = diametros_componentes,
+		.exc_inf = exc_inf,
+		.exc_sup = exc_sup,
+		.proxima_componente = 0,
+		.erro = 0
+	};
+
+	if (sucesso) {
+		executa_paralelo(num_threads < num_componentes ? num_threads : num_componentes, trabalhador_limitantes, &ctx);
+	}
+
+	free(exc_inf);
+	free(exc_sup);
+	free(candidatos);
+	return sucesso && !ctx.erro;
+}
+
+// Busca em profundidade iterativa (Tarjan) que encontra, numa unica passada, os vertices de corte
+// e as pontes de g. A pilha e explicita, entao nao ha limite de profundidade
+// proxima[u] e a posicao, na adjacencia de u, do proximo vizinho a examinar
+// Arestas para o pai nao contam como arestas de retorno, entao arestas multiplas entre
+// dois vertices sao tratadas como uma so
+cortes *calcula_cortes(grafo *g) {
+	cortes *c = (cortes*) malloc(sizeof(cortes));
+	if (!c) {
+		return NULL;
+	}
+
+	size_t tamanho = g->num_vertices ? g->num_vertices : 1;
+	c->eh_corte = (unsigned int*) calloc(tamanho, sizeof(unsigned int));
+	c->vertices_ordenados = NULL;
+	c->num_vertices_corte = 0;
+	c->pontes = (unsigned int*) malloc(sizeof(unsigned int) * 2 * tamanho);
+	c->num_pontes = 0;
+	c->tempo_descoberta = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	c->low = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	c->pai = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	c->bloco = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	c->no_arvore = NULL;
+	c->componente_sem_pontes = NULL;
+	c->num_blocos = 0;
+
+	unsigned int *tempo_descoberta = c->tempo_descoberta;
+	unsigned int *low = c->low;
+	unsigned int *pai = c->pai;
+	unsigned int *proxima = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	unsigned int *pilha = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+
+	if ((!c->eh_corte) || (!c->pontes) || (!tempo_descoberta) || (!low) || (!pai) || (!c->bloco) || (!proxima) || (!pilha)) {
+		free(proxima);
+		free(pilha);
+		destroi_cortes(c);
+		return NULL;
+	}
+
+	for (unsigned int i = 0; i < g->num_vertices; i++) {
+		tempo_descoberta[i] = UINT_MAX;
+	}
+
+	unsigned int tempo_atual = 0;
+	CONTA(vertices_visitados, g->num_vertices);
+	CONTA(bytes_alocados, sizeof(unsigned int) * 9 * tamanho);
+
+	for (unsigned int raiz = 0; raiz < g->num_vertices; raiz++) {
+		if (tempo_descoberta[raiz] != UINT_MAX) {
+			continue;
+		}
+
+		unsigned int topo = 0;
+		unsigned int filhos_raiz = 0;
+
+		tempo_descoberta[raiz] = low[raiz] = tempo_atual++;
+		pai[raiz] = UINT_MAX;
+		proxima[raiz] = g->inicio_adj[raiz];
+		pilha[topo++] = raiz;
+
+		while (topo > 0) {
+			unsigned int u = pilha[topo - 1];
+
+			// Ainda ha vizinhos de u a examinar
+			if (proxima[u] < g->inicio_adj[u + 1]) {
+				unsigned int v = g->vizinhos[proxima[u]++];
+				CONTA(arestas_examinadas, 1);
+
+				if (tempo_descoberta[v] == UINT_MAX) {
+					tempo_descoberta[v] = low[v] = tempo_atual++;
+					pai[v] = u;
+					proxima[v] = g->inicio_adj[v];
+					pilha[topo++] = v;
+
+					if (u == raiz) {
+						filhos_raiz++;
+					}
+				} else if ((v != pai[u]) && (tempo_descoberta[v] < low[u])) {
+					low[u] = tempo_descoberta[v];
+				}
+				continue;
+			}
+
+			// u terminou: repassa seu low ao pai e verifica a aresta pai -- u
+			topo--;
+			unsigned int p = pai[u];
+			if (p == UINT_MAX) {
+				continue;
+			}
+
+			if (low[u] < low[p]) {
+				low[p] = low[u];
+			}
+
+			if ((p != raiz) && (low[u] >= tempo_descoberta[p])) {
+				c->eh_corte[p] = 1;
+			}
+
+			if (low[u] > tempo_descoberta[p]) {
+				c->pontes[2 * c->num_pontes] = p;
+				c->pontes[2 * c->num_pontes + 1] = u;
+				c->num_pontes++;
+			}
+		}
+
+		if (filhos_raiz >= 2) {
+			c->eh_corte[raiz] = 1;
+		}
+	}
+
+	// Blocos das arestas da arvore em pre-ordem (pilha passa a guardar os vertices por tempo de
+	// descoberta): a aresta pai -- v comeca um bloco novo se a subarvore de v nao sobe alem do pai,
+	// e senao fica no bloco da aresta de cima
+	for (unsigned int v = 0; v < g->num_vertices; v++) {
+		pilha[tempo_descoberta[v]] = v;
+	}
+	for (unsigned int i = 0; i < g->num_vertices; i++) {
+		unsigned int v = pilha[i];
+		unsigned int p = pai[v];
+
+		if (p != UINT_MAX) {
+			c->bloco[v] = ((pai[p] == UINT_MAX) || (low[v] >= tempo_descoberta[p])) ? v : c->bloco[p];
+		}
+	}
+
+	free(proxima);
+	free(pilha);
+	return c;
+}
+
+// Trabalho de cada thread numa fase de cortes_paralelos, sobre sua faixa de vertices
+// As arestas de um vertice para seu pai (todas as copias) nao contam, como em calcula_cortes
+void trabalhador_biconexas(void *contexto, unsigned int id_thread) {
+	contexto_biconexas *ctx = (contexto_biconexas*) contexto;
+	grafo *g = ctx->g;
+	unsigned int *pai = ctx->pai;
+	unsigned int *pre = ctx->pre;
+	unsigned int inicio = (unsigned int) ((uint64_t) g->num_vertices * id_thread / ctx->num_threads);
+	unsigned int fim = (unsigned int) ((uint64_t) g->num_vertices * (id_thread + 1) / ctx->num_threads);
+
+	for (unsigned int v = inicio; v < fim; v++) {
+		switch (ctx->fase) {
+			case FASE_EXTREMOS: {
+				// Menor e maior pre-ordem entre v e seus vizinhos
+				unsigned int baixo = pre[v];
+				unsigned int alto = pre[v];
+
+				CONTA(arestas_examinadas, g->inicio_adj[v + 1] - g->inicio_adj[v]);
+				for (unsigned int j = g->inicio_adj[v]; j < g->inicio_adj[v + 1]; j++) {
+					unsigned int w = g->vizinhos[j];
+
+					if (w == pai[v]) {
+						continue;
+					}
+					baixo = pre[w] < baixo ? pre[w] : baixo;
+					alto = pre[w] > alto ? pre[w] : alto;
+				}
+
+				ctx->baixo[v] = baixo;
+				ctx->alto[v] = alto;
+				break;
+			}
+
+			case FASE_UNIAO: {
+				// Regra da arvore: a aresta de v e a de seu pai ficam no mesmo bloco se a subarvore
+				// de v alcanca, sem passar pelo pai, algum vertice fora da subarvore do pai
+				if ((pai[v] != UINT_MAX) && (pai[pai[v]] != UINT_MAX)) {
+					unsigned int p = pai[v];
+
+					if ((ctx->baixo[v] < pre[p]) || (ctx->alto[v] >= pre[p] + ctx->tamanho[p])) {
+						une_atomico(ctx->classe, v, p);
+					}
+				}
+
+				// Regra das arestas fora da arvore: se v e w nao sao um ancestral do outro, as
+				// arestas de v e de w ficam no mesmo bloco (cada par e visto so pelo lado de menor pre)
+				CONTA(arestas_examinadas, g->inicio_adj[v + 1] - g->inicio_adj[v]);
+				for (unsigned int j = g->inicio_adj[v]; j < g->inicio_adj[v + 1]; j++) {
+					unsigned int w = g->vizinhos[j];
+
+					if ((pre[w] > pre[v]) && (pre[w] >= pre[v] + ctx->tamanho[v])) {
+						une_atomico(ctx->classe, v, w);
+					}
+				}
+				break;
+			}
+
+			case FASE_COMPRESSAO:
+				comprime_faixa(ctx->classe, v, v + 1);
+				break;
+
+			case FASE_CORTES: {
+				// Ponte: nenhuma aresta sai da subarvore de v a nao ser a que vai para o pai
+				if ((pai[v] != UINT_MAX) && (ctx->baixo[v] >= pre[v]) && (ctx->alto[v] < pre[v] + ctx->tamanho[v])) {
+					ctx->eh_ponte[v] = 1;
+				}
+
+				// Vertice de corte: as arestas da arvore que tocam v estao em mais de um bloco
+				unsigned int primeiro = ctx->inicio_filhos[v];
+				unsigned int ultimo = ctx->inicio_filhos[v + 1];
+				if (primeiro == ultimo) {
+					break;
+				}
+
+				unsigned int referencia = (pai[v] != UINT_MAX) ? ctx->classe[v] : ctx->classe[ctx->filhos[primeiro]];
+				for (unsigned int i = primeiro; i < ultimo; i++) {
+					if (ctx->classe[ctx->filhos[i]] != referencia) {
+						ctx->eh_corte[v] = 1;
+						break;
+					}
+				}
+				break;
+			}
+		}
+	}
+
+	if (ctx->num_threads > 1) {
+		ESTATISTICA(junta_contadores(g);)
+	}
+}
+
+// Vertices de corte e pontes de g com num_threads threads (Tarjan-Vishkin), sem busca em profundidade:
+// a arvore geradora vem da busca por niveis, pre-ordem e tamanhos das subarvores de passadas sobre
+// ordem, e os blocos de uma uniao-busca sobre as arestas da arvore. As passadas sobre arestas sao
+// divididas entre as threads; as passadas sobre a arvore, lineares nos vertices, sao sequenciais
+// O resultado tem os mesmos vertices de corte e pontes de calcula_cortes; tempo_descoberta recebe
+// a pre-ordem, low o menor vizinho alcancado por cada subarvore, pai a arvore da busca e bloco as
+// classes da uniao-busca
+// Se blocos nao e NULL, recebe a arvore da busca, os niveis e os blocos (inicia_blocos)
+cortes *cortes_paralelos(grafo *g, unsigned int num_threads, blocos_incrementais *blocos) {
+	unsigned int num_vertices = g->num_vertices;
+	size_t tamanho = num_vertices ? num_vertices : 1;
+	cortes *c = (cortes*) calloc(1, sizeof(cortes));
+	if (!c) {
+		return NULL;
+	}
+
+	c->eh_corte = (unsigned int*) calloc(tamanho, sizeof(unsigned int));
+	c->pontes = (unsigned int*) malloc(sizeof(unsigned int) * 2 * tamanho);
+	c->tempo_descoberta = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	c->low = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	c->pai = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+
+	unsigned int *nivel = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	unsigned int *ordem = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	unsigned int *inicio_componente = (unsigned int*) malloc(sizeof(unsigned int) * (tamanho + 1));
+	unsigned int *inicio_filhos = (unsigned int*) calloc(tamanho + 1, sizeof(unsigned int));
+	unsigned int *filhos = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	unsigned int *alto = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	unsigned int *classe = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	unsigned char *eh_ponte = (unsigned char*) calloc(tamanho, 1);
+	unsigned int num_componentes;
+
+	unsigned int sucesso = (c->eh_corte) && (c->pontes) && (c->tempo_descoberta) && (c->low) && (c->pai) &&
+	                       (nivel) && (ordem) && (inicio_componente) && (inicio_filhos) && (filhos) && (alto) && (classe) && (eh_ponte) &&
+	                       (busca_niveis(g, num_threads, nivel, c->pai, ordem, inicio_componente, &num_componentes));
+
+	if (sucesso) {
+		CONTA(bytes_alocados, (sizeof(unsigned int) * 14 + 1) * tamanho);
+		unsigned int *pai = c->pai;
+		unsigned int *pre = c->tempo_descoberta;
+		unsigned int *tamanho_subarvore = nivel;
+
+		if (blocos) {
+			memcpy(blocos->profundidade, nivel, sizeof(unsigned int) * num_vertices);
+		}
+
+		// Filhos de cada vertice, agrupados por contagem
+		for (unsigned int v = 0; v < num_vertices; v++) {
+			if (pai[v] != UINT_MAX) {
+				inicio_filhos[pai[v] + 1]++;
+			}
+		}
+		for (unsigned int v = 0; v < num_vertices; v++) {
+			inicio_filhos[v + 1] += inicio_filhos[v];
+		}
+		memcpy(classe, inicio_filhos, sizeof(unsigned int) * num_vertices);
+		for (unsigned int i = 0; i < num_vertices; i++) {
+			unsigned int v = ordem[i];
+			if (pai[v] != UINT_MAX) {
+				filhos[classe[pai[v]]++] = v;
+			}
+		}
+
+		// Tamanhos das subarvores de baixo para cima (ordem tem cada pai antes dos filhos),
+		// e pre-ordem de cima para baixo: os filhos de v ocupam, em sequencia, as posicoes depois de v
+		for (unsigned int v = 0; v < num_vertices; v++) {
+			tamanho_subarvore[v] = 1;
+		}
+		for (unsigned int i = num_vertices; i > 0; i--) {
+			unsigned int v = ordem[i - 1];
+			if (pai[v] != UINT_MAX) {
+				tamanho_subarvore[pai[v]] += tamanho_subarvore[v];
+			}
+		}
+		for (unsigned int i = 0; i < num_vertices; i++) {
+			unsigned int v = ordem[i];
+			if (pai[v] == UINT_MAX) {
+				pre[v] = i;
+			}
+
+			unsigned int proxima = pre[v] + 1;
+			for (unsigned int j = inicio_filhos[v]; j < inicio_filhos[v + 1]; j++) {
+				pre[filhos[j]] = proxima;
+				proxima += tamanho_subarvore[filhos[j]];
+			}
+		}
+
+		contexto_biconexas ctx = {
+			.g = g,
+			.num_threads = (g->inicio_adj[num_vertices] >= MINIMO_PASSO_PARALELO) ? num_threads : 1,
+			.pai = pai,
+			.pre = pre,
+			.tamanho = tamanho_subarvore,
+			.inicio_filhos = inicio_filhos,
+			.filhos = filhos,
+			.baixo = c->low,
+			.alto = alto,
+			.classe = classe,
+			.eh_corte = c->eh_corte,
+			.eh_ponte = eh_ponte
+		};
+
+		ctx.fase = FASE_EXTREMOS;
+		executa_paralelo(ctx.num_threads, trabalhador_biconexas, &ctx);
+
+		// Extremos das subarvores, de baixo para cima
+		for (unsigned int i = num_vertices; i > 0; i--) {
+			unsigned int v = ordem[i - 1];
+			unsigned int p = pai[v];
+
+			if (p != UINT_MAX) {
+				c->low[p] = c->low[v] < c->low[p] ? c->low[v] : c->low[p];
+				alto[p] = alto[v] > alto[p] ? alto[v] : alto[p];
+			}
+		}
+
+		for (unsigned int v = 0; v < num_vertices; v++) {
+			classe[v] = v;
+		}
+		ctx.fase = FASE_UNIAO;
+		executa_paralelo(ctx.num_threads, trabalhador_biconexas, &ctx);
+		ctx.fase = FASE_COMPRESSAO;
+		executa_paralelo(ctx.num_threads, trabalhador_biconexas, &ctx);
+		if (blocos) {
+			inicia_blocos(blocos, num_vertices, pai, classe);
+		}
+		ctx.fase = FASE_CORTES;
+		executa_paralelo(ctx.num_threads, trabalhador_biconexas, &ctx);
+
+		CONTA(vertices_visitados, num_vertices);
+		for (unsigned int v = 0; v < num_vertices; v++) {
+			if (eh_ponte[v]) {
+				c->pontes[2 * c->num_pontes] = pai[v];
+				c->pontes[2 * c->num_pontes + 1] = v;
+				c->num_pontes++;
+			}
+		}
+	}
+
+	// As classes comprimidas ja identificam os blocos das arestas da arvore
+	if (sucesso) {
+		c->bloco = classe;
+		classe = NULL;
+	}
+
+	free(nivel);
+	free(ordem);
+	free(inicio_componente);
+	free(inicio_filhos);
+	free(filhos);
+	free(alto);
+	free(classe);
+	free(eh_ponte);
+
+	if (!sucesso) {
+		destroi_cortes(c);
+		return NULL;
+	}
+
+	return c;
+}
+
+// Libera o resultado de calcula_cortes
+void destroi_cortes(cortes *c) {
+	if (!c) {
+		return;
+	}
+
+	free(c->eh_corte);
+	free(c->vertices_ordenados);
+	free(c->pontes);
+	free(c->tempo_descoberta);
+	free(c->low);
+	free(c->pai);
+	free(c->bloco);
+	free(c->no_arvore);
+	free(c->componente_sem_pontes);
+	free(c);
+}
+
+// Calcula (uma vez por grafo) a posicao de cada vertice na ordem alfabetica dos nomes
+// Como os nomes sao distintos, comparar postos da exatamente a mesma ordem que strcmp
+// So os vertices criados depois do ultimo calculo obrigam a refaze-lo
+unsigned int calcula_postos(grafo *g) {
+	if ((g->posto_nome) && (g->vertices_postos == g->num_vertices)) {
+		return 1;
+	}
+
+	size_t tamanho = g->num_vertices ? g->num_vertices : 1;
+	vertice_nomeado *nomeados = (vertice_nomeado*) malloc(sizeof(vertice_nomeado) * tamanho);
+	unsigned int *posto_nome = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	unsigned int *ordem_nomes = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+
+	if ((!nomeados) || (!posto_nome) || (!ordem_nomes)) {
+		free(nomeados);
+		free(posto_nome);
+		free(ordem_nomes);
+		return 0;
+	}
+	CONTA(bytes_alocados, sizeof(unsigned int) * 2 * tamanho);
+
+	for (unsigned int i = 0; i < g->num_vertices; i++) {
+		nomeados[i].nome = g->vertices[i].nome;
+		nomeados[i].indice = i;
+	}
+
+	qsort(nomeados, g->num_vertices, sizeof(vertice_nomeado), compara_nome_vertices);
+	for (unsigned int i = 0; i < g->num_vertices; i++) {
+		ordem_nomes[i] = nomeados[i].indice;
+		posto_nome[nomeados[i].indice] = i;
+	}
+	free(nomeados);
+
+	free(g->posto_nome);
+	free(g->ordem_nomes);
+	g->posto_nome = posto_nome;
+	g->ordem_nomes = ordem_nomes;
+	g->vertices_postos = g->num_vertices;
+	return 1;
+}
+
+// Poe os vertices de corte e as pontes de c na ordem alfabetica das respostas, sem comparar nomes:
+// os vertices de corte saem de ordem_nomes e as pontes de uma ordenacao por contagem estavel em duas
+// passadas (pelo posto da segunda ponta e depois pelo da primeira)
+// Os vetores ordenados ficam guardados, entao as consultas seguintes nao alocam nem ordenam
+unsigned int ordena_cortes(grafo *g, cortes *c) {
+	if (!calcula_postos(g)) {
+		return 0;
+	}
+
+	unsigned int num_vertices_corte = 0;
+	for (unsigned int i = 0; i < g->num_vertices; i++) {
+		num_vertices_corte += c->eh_corte[i];
+	}
+
+	size_t tamanho_pontes = 2 * (size_t) (c->num_pontes ? c->num_pontes : 1);
+	unsigned int *contagem = (unsigned int*) malloc(sizeof(unsigned int) * ((size_t) g->num_vertices + 1));
+	unsigned int *auxiliar = (unsigned int*) malloc(sizeof(unsigned int) * tamanho_pontes);
+	c->vertices_ordenados = (unsigned int*) malloc(sizeof(unsigned int) * (num_vertices_corte ? num_vertices_corte : 1));
+
+	if ((!contagem) || (!auxiliar) || (!c->vertices_ordenados)) {
+		free(contagem);
+		free(auxiliar);
+		return 0;
+	}
+
+	for (unsigned int i = 0; i < g->num_vertices; i++) {
+		unsigned int v = g->ordem_nomes[i];
+
+		if (c->eh_corte[v]) {
+			c->vertices_ordenados[c->num_vertices_corte++] = v;
+		}
+	}
+
+	// Cada ponte fica com as pontas em ordem alfabetica
+	const unsigned int *posto = g->posto_nome;
+	for (unsigned int i = 0; i < c->num_pontes; i++) {
+		unsigned int u = c->pontes[2 * i];
+		unsigned int v = c->pontes[2 * i + 1];
+
+		if (posto[u] > posto[v]) {
+			c->pontes[2 * i] = v;
+			c->pontes[2 * i + 1] = u;
+		}
+	}
+
+	// Ordenacao por contagem: primeiro pela segunda ponta (de pontes para auxiliar),
+	// depois, estavel, pela primeira (de auxiliar de volta para pontes)
+	unsigned int *origem = c->pontes;
+	unsigned int *destino = auxiliar;
+	for (unsigned int ponta = 2; ponta > 0; ponta--) {
+		memset(contagem, 0, sizeof(unsigned int) * ((size_t) g->num_vertices + 1));
+		for (unsigned int i = 0; i < c->num_pontes; i++) {
+			contagem[posto[origem[2 * i + ponta - 1]] + 1]++;
+		}
+		for (unsigned int i = 0; i < g->num_vertices; i++) {
+			contagem[i + 1] += contagem[i];
+		}
+
+		for (unsigned int i = 0; i < c->num_pontes; i++) {
+			unsigned int posicao = contagem[posto[origem[2 * i + ponta - 1]]]++;
+			destino[2 * posicao] = origem[2 * i];
+			destino[2 * posicao + 1] = origem[2 * i + 1];
+		}
+
+		unsigned int *troca = origem;
+		origem = destino;
+		destino = troca;
+	}
+
+	free(contagem);
+	free(auxiliar);
+	return 1;
+}
+
+// Indexa os cortes c de g (depois de ordena_cortes) para as consultas pontuais, em tempo linear
+// Os blocos sao numerados em ordem pelos dois menores vertices de cada um (dois blocos tem no maximo
+// um vertice em comum), entao a numeracao nao depende da busca que calculou os cortes; um vertice
+// isolado forma um bloco sozinho. As componentes sem pontes saem de subir a arvore pai ate um
+// vertice ja rotulado, uma raiz ou uma ponte, rotulando o caminho de uma vez
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int indexa_cortes(grafo *g, cortes *c) {
+	unsigned int num_vertices = g->num_vertices;
+	size_t tamanho = num_vertices ? num_vertices : 1;
+	unsigned int *menor = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	unsigned int *segundo = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	unsigned int *arestas_bloco = (unsigned int*) calloc(tamanho, sizeof(unsigned int));
+	unsigned int *entradas = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	unsigned int *auxiliar = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	unsigned int *contagem = (unsigned int*) malloc(sizeof(unsigned int) * (tamanho + 2));
+	unsigned int *no_arvore = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	unsigned int *componente = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+
+	if ((!menor) || (!segundo) || (!arestas_bloco) || (!entradas) || (!auxiliar) || (!contagem) || (!no_arvore) || (!componente)) {
+		free(menor);
+		free(segundo);
+		free(arestas_bloco);
+		free(entradas);
+		free(auxiliar);
+		free(contagem);
+		free(no_arvore);
+		free(componente);
+		return 0;
+	}
+	CONTA(bytes_alocados, sizeof(unsigned int) * 8 * tamanho);
+	CONTA(vertices_visitados, num_vertices);
+
+	const unsigned int *pai = c->pai;
+	const unsigned int *bloco = c->bloco;
+	for (unsigned int v = 0; v < num_vertices; v++) {
+		menor[v] = segundo[v] = UINT_MAX;
+		no_arvore[v] = UINT_MAX;
+		componente[v] = UINT_MAX;
+	}
+
+	// Dois menores vertices e numero de arestas da arvore de cada bloco; cada raiz guarda por
+	// enquanto o bloco de uma das arestas para seus filhos
+	for (unsigned int v = 0; v < num_vertices; v++) {
+		unsigned int p = pai[v];
+		if (p == UINT_MAX) {
+			continue;
+		}
+
+		unsigned int b = bloco[v];
+		arestas_bloco[b]++;
+		unsigned int pontas[2] = {v, p};
+		for (unsigned int lado = 0; lado < 2; lado++) {
+			unsigned int x = pontas[lado];
+			if (x < menor[b]) {
+				segundo[b] = menor[b];
+				menor[b] = x;
+			} else if ((x != menor[b]) && (x < segundo[b])) {
+				segundo[b] = x;
+			}
+		}
+
+		if (pai[p] == UINT_MAX) {
+			no_arvore[p] = b;
+		}
+	}
+
+	// Vertices isolados: nenhum bloco e identificado por uma raiz, entao o indice do vertice serve
+	unsigned int num_entradas = 0;
+	for (unsigned int v = 0; v < num_vertices; v++) {
+		if ((pai[v] == UINT_MAX) && (no_arvore[v] == UINT_MAX)) {
+			menor[v] = v;
+			no_arvore[v] = v;
+		}
+		if (menor[v] != UINT_MAX) {
+			entradas[num_entradas++] = v;
+		}
+	}
+
+	// Ordenacao por contagem pelo segundo menor vertice (os isolados, sem segundo, por ultimo) e
+	// depois, estavel, pelo menor; o resultado volta para entradas
+	unsigned int *origem = entradas;
+	unsigned int *destino = auxiliar;
+	for (unsigned int passada = 0; passada < 2; passada++) {
+		const unsigned int *chave = passada ? menor : segundo;
+
+		memset(contagem, 0, sizeof(unsigned int) * ((size_t) num_vertices + 2));
+		for (unsigned int i = 0; i < num_entradas; i++) {
+			unsigned int k = chave[origem[i]];
+			contagem[(k == UINT_MAX ? num_vertices : k) + 1]++;
+		}
+		for (unsigned int i = 0; i <= num_vertices; i++) {
+			contagem[i + 1] += contagem[i];
+		}
+		for (unsigned int i = 0; i < num_entradas; i++) {
+			unsigned int k = chave[origem[i]];
+			destino[contagem[k == UINT_MAX ? num_vertices : k]++] = origem[i];
+		}
+
+		unsigned int *troca = origem;
+		origem = destino;
+		destino = troca;
+	}
+
+	// auxiliar passa a guardar o numero de cada bloco
+	for (unsigned int i = 0; i < num_entradas; i++) {
+		auxiliar[entradas[i]] = i;
+	}
+
+	for (unsigned int v = 0; v < num_vertices; v++) {
+		no_arvore[v] = auxiliar[(pai[v] != UINT_MAX) ? bloco[v] : no_arvore[v]];
+	}
+	for (unsigned int i = 0; i < c->num_vertices_corte; i++) {
+		no_arvore[c->vertices_ordenados[i]] = num_entradas + i;
+	}
+
+	// Componentes sem pontes, usando entradas como pilha; uma aresta da arvore e ponte se esta
+	// sozinha no seu bloco
+	unsigned int num_componentes = 0;
+	for (unsigned int v = 0; v < num_vertices; v++) {
+		unsigned int topo = 0;
+		unsigned int x = v;
+
+		while (componente[x] == UINT_MAX) {
+			entradas[topo++] = x;
+			if ((pai[x] == UINT_MAX) || (arestas_bloco[bloco[x]] == 1)) {
+				break;
+			}
+			x = pai[x];
+		}
+
+		unsigned int rotulo = (componente[x] != UINT_MAX) ? componente[x] : num_componentes++;
+		while (topo > 0) {
+			componente[entradas[--topo]] = rotulo;
+		}
+	}
+
+	free(menor);
+	free(segundo);
+	free(arestas_bloco);
+	free(entradas);
+	free(auxiliar);
+	free(contagem);
+
+	c->no_arvore = no_arvore;
+	c->componente_sem_pontes = componente;
+	c->num_blocos = num_entradas;
+	return 1;
+}
+
+// Descarta tudo o que esta guardado em a (a propria estrutura continua valida)
+void limpa_analise(grafo_analise *a) {
+	free(a->componente);
+	free(a->ordem);
+	free(a->inicio_componente);
+	free(a->cor);
+	destroi_cortes(a->dados_cortes);
+	free(a->diametros);
+
+	a->tem_componentes = 0;
+	a->tem_cores = 0;
+	a->num_componentes = 0;
+	a->componente = NULL;
+	a->ordem = NULL;
+	a->inicio_componente = NULL;
+	a->bipartido = 0;
+	a->cor = NULL;
+	a->dados_cortes = NULL;
+	a->diametros = NULL;
+}
+
+// Retorna a analise de g, criando-a vazia se preciso
+// Se g mudou desde que a analise foi feita, os resultados guardados sao descartados
+grafo_analise *analise_atual(grafo *g) {
+	if (!g->analise) {
+		g->analise = (grafo_analise*) calloc(1, sizeof(grafo_analise));
+		if (!g->analise) {
+			return NULL;
+		}
+		g->analise->versao = g->versao;
+	}
+
+	if (g->analise->versao != g->versao) {
+		limpa_analise(g->analise);
+		g->analise->versao = g->versao;
+	}
+
+	return g->analise;
+}
+
+// Como analise_atual, mas antes reconstroi a adjacencia com as arestas inseridas
+grafo_analise *obtem_analise(grafo *g) {
+	if (!garante_adjacencia(g)) {
+		return NULL;
+	}
+
+	return analise_atual(g);
+}
+
+// Passo de cima para baixo: cada thread percorre sua parte da fronteira e toma para si, com
+// compare-and-swap no nivel, os vizinhos ainda nao visitados
+void passo_cima_baixo(void *contexto, unsigned int id_thread) {
+	contexto_busca *ctx = (contexto_busca*) contexto;
+	grafo *g = ctx->g;
+	descobertos_thread *d = &ctx->descobertos[id_thread];
+	unsigned int tamanho_fronteira = ctx->fim_fronteira - ctx->inicio_fronteira;
+	unsigned int inicio = ctx->inicio_fronteira + (unsigned int) ((uint64_t) tamanho_fronteira * id_thread / ctx->num_partes);
+	unsigned int fim = ctx->inicio_fronteira + (unsigned int) ((uint64_t) tamanho_fronteira * (id_thread + 1) / ctx->num_partes);
+
+	for (unsigned int i = inicio; i < fim; i++) {
+		unsigned int u = ctx->ordem[i];
+		CONTA(arestas_examinadas, g->inicio_adj[u + 1] - g->inicio_adj[u]);
+
+		for (unsigned int j = g->inicio_adj[u]; j < g->inicio_adj[u + 1]; j++) {
+			unsigned int v = g->vizinhos[j];
+			unsigned int esperado = NAO_VISITADO;
+
+			if ((__atomic_load_n(&ctx->nivel[v], __ATOMIC_RELAXED) != NAO_VISITADO) ||
+			    (!__atomic_compare_exchange_n(&ctx->nivel[v], &esperado, ctx->nivel_atual + 1, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))) {
+				continue;
+			}
+			if (ctx->pai) {
+				ctx->pai[v] = u;
+			}
+
+			if (d->tamanho == d->capacidade) {
+				unsigned int nova_capacidade = d->capacidade ? 2 * d->capacidade : 1024;
+				unsigned int *realocacao = (unsigned int*) realloc(d->vertices, sizeof(unsigned int) * nova_capacidade);
+
+				if (!realocacao) {
+					__atomic_store_n(&ctx->erro, 1, __ATOMIC_RELAXED);
+					return;
+				}
+				d->vertices = realocacao;
+				d->capacidade = nova_capacidade;
+			}
+
+			d->vertices[d->tamanho++] = v;
+			d->arestas += g->inicio_adj[v + 1] - g->inicio_adj[v];
+		}
+	}
+
+	if (ctx->num_partes > 1) {
+		ESTATISTICA(junta_contadores(g);)
+	}
+}
+
+// Passo de baixo para cima: cada vertice ainda nao visitado procura algum vizinho na fronteira
+// e para no primeiro que encontrar. Cada thread cuida de palavras inteiras de proxima, entao
+// ninguem escreve na mesma palavra
+void passo_baixo_cima(void *contexto, unsigned int id_thread) {
+	contexto_busca *ctx = (contexto_busca*) contexto;
+	grafo *g = ctx->g;
+	descobertos_thread *d = &ctx->descobertos[id_thread];
+	unsigned int primeira_palavra = (unsigned int) ((uint64_t) ctx->num_palavras * id_thread / ctx->num_partes);
+	unsigned int ultima_palavra = (unsigned int) ((uint64_t) ctx->num_palavras * (id_thread + 1) / ctx->num_partes);
+
+	for (unsigned int p = primeira_palavra; p < ultima_palavra; p++) {
+		uint64_t bits = 0;
+		unsigned int fim = (p + 1) * 64 < g->num_vertices ? (p + 1) * 64 : g->num_vertices;
+
+		for (unsigned int v = p * 64; v < fim; v++) {
+			if (ctx->nivel[v] != NAO_VISITADO) {
+				continue;
+			}
+
+			for (unsigned int j = g->inicio_adj[v]; j < g->inicio_adj[v + 1]; j++) {
+				unsigned int u = g->vizinhos[j];
+				CONTA(arestas_examinadas, 1);
+
+				if (ctx->fronteira[u / 64] & ((uint64_t) 1 << (u % 64))) {
+					ctx->nivel[v] = ctx->nivel_atual + 1;
+					if (ctx->pai) {
+						ctx->pai[v] = u;
+					}
+					bits |= (uint64_t) 1 << (v % 64);
+					d->tamanho++;
+					d->arestas += g->inicio_adj[v + 1] - g->inicio_adj[v];
+					break;
+				}
+			}
+		}
+
+		ctx->proxima[p] = bits;
+	}
+
+	if (ctx->num_partes > 1) {
+		ESTATISTICA(junta_contadores(g);)
+	}
+}
+
+// Busca em largura por niveis, sobre todo o grafo, que escolhe a cada nivel entre o passo de
+// cima para baixo e o de baixo para cima (Beamer): quando as arestas da fronteira passam de
+// 1/ALFA_BUSCA das arestas ainda nao visitadas, examinar a partir dos nao visitados, que param no
+// primeiro pai, fica mais barato; a busca volta para cima quando a fronteira encolhe abaixo de
+// 1/BETA_BUSCA dos vertices. Passos grandes sao divididos entre num_threads threads
+// Cada componente comeca em seu menor vertice; nivel[v] e a distancia de v a ele, ordem tem os
+// vertices agrupados por componente e, dentro dela, por nivel, e inicio_componente e preenchido
+// como em grafo_analise. Se pai nao e NULL, recebe a arvore da busca (UINT_MAX nas raizes)
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int busca_niveis(grafo *g, unsigned int num_threads, unsigned int *nivel, unsigned int *pai, unsigned int *ordem, unsigned int *inicio_componente, unsigned int *num_componentes) {
+	unsigned int num_vertices = g->num_vertices;
+	unsigned int num_palavras = (num_vertices + 63) / 64;
+	contexto_busca ctx = {
+		.g = g,
+		.nivel = nivel,
+		.pai = pai,
+		.ordem = ordem,
+		.num_palavras = num_palavras,
+		.fronteira = (uint64_t*) malloc(sizeof(uint64_t) * (num_palavras ? num_palavras : 1)),
+		.proxima = (uint64_t*) malloc(sizeof(uint64_t) * (num_palavras ? num_palavras : 1)),
+		.descobertos = (descobertos_thread*) calloc(num_threads, sizeof(descobertos_thread)),
+		.erro = 0
+	};
+
+	if ((!ctx.fronteira) || (!ctx.proxima) || (!ctx.descobertos)) {
+		free(ctx.fronteira);
+		free(ctx.proxima);
+		free(ctx.descobertos);
+		return 0;
+	}
+	CONTA(bytes_alocados, 2 * sizeof(uint64_t) * num_palavras);
+
+	for (unsigned int v = 0; v < num_vertices; v++) {
+		nivel[v] = NAO_VISITADO;
+	}
+
+	uint64_t arestas_nao_visitadas = g->inicio_adj[num_vertices];
+	unsigned int tras = 0;
+	unsigned int componentes = 0;
+
+	for (unsigned int raiz = 0; (raiz < num_vertices) && (!ctx.erro); raiz++) {
+		if (nivel[raiz] != NAO_VISITADO) {
+			continue;
+		}
+
+		inicio_componente[componentes++] = tras;
+		nivel[raiz] = 0;
+		if (pai) {
+			pai[raiz] = UINT_MAX;
+		}
+		ordem[tras++] = raiz;
+		ctx.inicio_fronteira = tras - 1;
+		ctx.fim_fronteira = tras;
+		ctx.nivel_atual = 0;
+
+		uint64_t arestas_fronteira = g->inicio_adj[raiz + 1] - g->inicio_adj[raiz];
+		arestas_nao_visitadas -= arestas_fronteira;
+		unsigned int baixo_cima = 0;
+		unsigned int tamanho_anterior = 0;
+
+		while ((ctx.fim_fronteira > ctx.inicio_fronteira) && (!ctx.erro)) {
+			unsigned int tamanho_fronteira = ctx.fim_fronteira - ctx.inicio_fronteira;
+
+			if ((!baixo_cima) && (arestas_fronteira > arestas_nao_visitadas / ALFA_BUSCA)) {
+				// A fronteira passa a ser tambem um mapa de bits
+				memset(ctx.fronteira, 0, sizeof(uint64_t) * num_palavras);
+				for (unsigned int i = ctx.inicio_fronteira; i < ctx.fim_fronteira; i++) {
+					ctx.fronteira[ordem[i] / 64] |= (uint64_t) 1 << (ordem[i] % 64);
+				}
+				baixo_cima = 1;
+			} else if ((baixo_cima) && (tamanho_fronteira < tamanho_anterior) && (tamanho_fronteira < num_vertices / BETA_BUSCA)) {
+				baixo_cima = 0;
+			}
+			tamanho_anterior = tamanho_fronteira;
+
+			uint64_t trabalho = baixo_cima ? num_vertices : arestas_fronteira;
+			ctx.num_partes = ((num_threads > 1) && (trabalho >= MINIMO_PASSO_PARALELO)) ? num_threads : 1;
+			for (unsigned int t = 0; t < ctx.num_partes; t++) {
+				ctx.descobertos[t].tamanho = 0;
+				ctx.descobertos[t].arestas = 0;
+			}
+
+			void (*passo)(void *, unsigned int) = baixo_cima ? passo_baixo_cima : passo_cima_baixo;
+			if (ctx.num_partes > 1) {
+				executa_paralelo(ctx.num_partes, passo, &ctx);
+			} else {
+				passo(&ctx, 0);
+			}
+
+			// A nova fronteira vai para o fim de ordem: na ordem das threads, ou na dos vertices
+			arestas_fronteira = 0;
+			if (baixo_cima) {
+				for (unsigned int p = 0; p < num_palavras; p++) {
+					uint64_t bits = ctx.proxima[p];
+
+					while (bits) {
+						ordem[tras++] = p * 64 + (unsigned int) __builtin_ctzll(bits);
+						bits &= bits - 1;
+					}
+				}
+
+				uint64_t *troca = ctx.fronteira;
+				ctx.fronteira = ctx.proxima;
+				ctx.proxima = troca;
+			} else {
+				for (unsigned int t = 0; t < ctx.num_partes; t++) {
+					if (ctx.descobertos[t].tamanho > 0) {
+						memcpy(ordem + tras, ctx.descobertos[t].vertices, sizeof(unsigned int) * ctx.descobertos[t].tamanho);
+					}
+					tras += ctx.descobertos[t].tamanho;
+				}
+			}
+			for (unsigned int t = 0; t < ctx.num_partes; t++) {
+				arestas_fronteira += ctx.descobertos[t].arestas;
+			}
+
+			CONTA(vertices_visitados, tamanho_fronteira);
+			arestas_nao_visitadas -= arestas_fronteira;
+			ctx.inicio_fronteira = ctx.fim_fronteira;
+			ctx.fim_fronteira = tras;
+			ctx.nivel_atual++;
+		}
+	}
+	inicio_componente[componentes] = tras;
+	*num_componentes = componentes;
+
+	for (unsigned int t = 0; t < num_threads; t++) {
+		free(ctx.descobertos[t].vertices);
+	}
+	free(ctx.descobertos);
+	free(ctx.fronteira);
+	free(ctx.proxima);
+	return !ctx.erro;
+}
+
+// Componentes de g pela busca por niveis; as cores saem de graca da paridade dos niveis
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int calcula_componentes(grafo *g, grafo_analise *a) {
+	size_t tamanho = g->num_vertices ? g->num_vertices : 1;
+	a->componente = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	a->ordem = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	a->inicio_componente = (unsigned int*) malloc(sizeof(unsigned int) * ((size_t) g->num_vertices + 1));
+	a->cor = (unsigned char*) malloc(tamanho);
+
+	if ((!a->componente) || (!a->ordem) || (!a->inicio_componente) || (!a->cor)) {
+		limpa_analise(a);
+		return 0;
+	}
+	CONTA(bytes_alocados, (3 * sizeof(unsigned int) + 1) * tamanho);
+
+	// componente guarda os niveis ate que as cores sejam tiradas deles
+	unsigned int num_componentes;
+	if (!busca_niveis(g, threads_efetivas(g), a->componente, NULL, a->ordem, a->inicio_componente, &num_componentes)) {
+		limpa_analise(a);
+		return 0;
+	}
+
+	for (unsigned int v = 0; v < g->num_vertices; v++) {
+		a->cor[v] = (unsigned char) (a->componente[v] & 1);
+	}
+	for (unsigned int c = 0; c < num_componentes; c++) {
+		for (unsigned int i = a->inicio_componente[c]; i < a->inicio_componente[c + 1]; i++) {
+			a->componente[a->ordem[i]] = c;
+		}
+	}
+
+	a->num_componentes = num_componentes;
+	a->tem_componentes = 1;
+	return 1;
+}
+
+// Trabalho de cada thread de confere_cores, sobre uma faixa de vertices
+void trabalhador_cores(void *contexto, unsigned int id_thread) {
+	contexto_cores *ctx = (contexto_cores*) contexto;
+	grafo *g = ctx->g;
+	unsigned int inicio = (unsigned int) ((uint64_t) g->num_vertices * id_thread / ctx->num_threads);
+	unsigned int fim = (unsigned int) ((uint64_t) g->num_vertices * (id_thread + 1) / ctx->num_threads);
+
+	for (unsigned int u = inicio; (u < fim) && (!__atomic_load_n(&ctx->conflito, __ATOMIC_RELAXED)); u++) {
+		CONTA(arestas_examinadas, g->inicio_adj[u + 1] - g->inicio_adj[u]);
+
+		for (unsigned int j = g->inicio_adj[u]; j < g->inicio_adj[u + 1]; j++) {
+			if (ctx->cor[g->vizinhos[j]] == ctx->cor[u]) {
+				__atomic_store_n(&ctx->conflito, 1, __ATOMIC_RELAXED);
+				break;
+			}
+		}
+	}
+
+	if (ctx->num_threads > 1) {
+		ESTATISTICA(junta_contadores(g);)
+	}
+}
+
+// Devolve 1 se nenhuma aresta de g liga vertices da mesma cor (ou seja, g e bipartido) e 0 caso
+// contrario; a procura para assim que alguma thread acha uma aresta assim
+unsigned int confere_cores(grafo *g, unsigned char *cor, unsigned int num_threads) {
+	contexto_cores ctx = {
+		.g = g,
+		.cor = cor,
+		.num_threads = (g->inicio_adj[g->num_vertices] >= MINIMO_PASSO_PARALELO) ? num_threads : 1,
+		.conflito = 0
+	};
+
+	if (ctx.num_threads > 1) {
+		executa_paralelo(ctx.num_threads, trabalhador_cores, &ctx);
+	} else {
+		trabalhador_cores(&ctx, 0);
+	}
+
+	return !ctx.conflito;
+}
+
+// Liga u e v na floresta pai sem travas: a raiz maior e pendurada na menor com compare-and-swap
+// Se outra thread mudou a raiz no meio do caminho, a subida e refeita a partir dos novos pais
+void une_atomico(unsigned int *pai, unsigned int u, unsigned int v) {
+	unsigned int pai_u = __atomic_load_n(&pai[u], __ATOMIC_RELAXED);
+	unsigned int pai_v = __atomic_load_n(&pai[v], __ATOMIC_RELAXED);
+
+	while (pai_u != pai_v) {
+		unsigned int maior = pai_u > pai_v ? pai_u : pai_v;
+		unsigned int menor = pai_u > pai_v ? pai_v : pai_u;
+		unsigned int pai_maior = __atomic_load_n(&pai[maior], __ATOMIC_RELAXED);
+
+		if (pai_maior == menor) {
+			break;
+		}
+		if ((pai_maior == maior) && (__atomic_compare_exchange_n(&pai[maior], &pai_maior, menor, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))) {
+			break;
+		}
+
+		pai_u = __atomic_load_n(&pai[__atomic_load_n(&pai[maior], __ATOMIC_RELAXED)], __ATOMIC_RELAXED);
+		pai_v = __atomic_load_n(&pai[menor], __ATOMIC_RELAXED);
+	}
+}
+
+// Faz cada vertice de inicio .. fim-1 apontar direto para sua raiz
+// Pais so diminuem, entao outras threads comprimindo ao mesmo tempo nao atrapalham
+void comprime_faixa(unsigned int *pai, unsigned int inicio, unsigned int fim) {
+	for (unsigned int v = inicio; v < fim; v++) {
+		unsigned int p = __atomic_load_n(&pai[v], __ATOMIC_RELAXED);
+		unsigned int avo = __atomic_load_n(&pai[p], __ATOMIC_RELAXED);
+
+		while (p != avo) {
+			p = avo;
+			avo = __atomic_load_n(&pai[p], __ATOMIC_RELAXED);
+		}
+		__atomic_store_n(&pai[v], p, __ATOMIC_RELAXED);
+	}
+}
+
+// Trabalho de cada thread numa fase de ligacao do Afforest, sobre sua faixa de vertices
+// Nas rodadas de amostragem cada vertice se liga so ao vizinho de posicao rodada; na fase final,
+// os vertices fora da componente grande se ligam aos vizinhos restantes. Como cada aresta aparece
+// na adjacencia das duas pontas, as arestas que saem da componente grande sao vistas pela outra ponta
+void trabalhador_componentes(void *contexto, unsigned int id_thread) {
+	contexto_componentes *ctx = (contexto_componentes*) contexto;
+	grafo *g = ctx->g;
+	unsigned int inicio = (unsigned int) ((uint64_t) g->num_vertices * id_thread / ctx->num_threads);
+	unsigned int fim = (unsigned int) ((uint64_t) g->num_vertices * (id_thread + 1) / ctx->num_threads);
+
+	for (unsigned int u = inicio; u < fim; u++) {
+		unsigned int primeira = g->inicio_adj[u] + ctx->rodada;
+
+		if (ctx->rodada < RODADAS_AFFOREST) {
+			if (primeira < g->inicio_adj[u + 1]) {
+				une_atomico(ctx->pai, u, g->vizinhos[primeira]);
+			}
+			continue;
+		}
+
+		if (__atomic_load_n(&ctx->pai[u], __ATOMIC_RELAXED) == ctx->componente_grande) {
+			continue;
+		}
+		CONTA(vertices_visitados, 1);
+		for (unsigned int j = primeira; j < g->inicio_adj[u + 1]; j++) {
+			CONTA(arestas_examinadas, 1);
+			une_atomico(ctx->pai, u, g->vizinhos[j]);
+		}
+	}
+}
+
+// Compressao da faixa de vertices de cada thread
+void trabalhador_compressao(void *contexto, unsigned int id_thread) {
+	contexto_componentes *ctx = (contexto_componentes*) contexto;
+	unsigned int num_vertices = ctx->g->num_vertices;
+	unsigned int inicio = (unsigned int) ((uint64_t) num_vertices * id_thread / ctx->num_threads);
+	unsigned int fim = (unsigned int) ((uint64_t) num_vertices * (id_thread + 1) / ctx->num_threads);
+
+	comprime_faixa(ctx->pai, inicio, fim);
+}
+
+// Estima a componente mais frequente depois das rodadas de amostragem, olhando a raiz de
+// AMOSTRAS_AFFOREST vertices escolhidos por um gerador fixo (o resultado final nao depende dela)
+unsigned int componente_frequente(unsigned int *pai, unsigned int num_vertices) {
+	unsigned int amostras[AMOSTRAS_AFFOREST];
+	uint64_t estado = 0x9E3779B97F4A7C15ull;
+
+	for (unsigned int i = 0; i < AMOSTRAS_AFFOREST; i++) {
+		estado ^= estado << 13;
+		estado ^= estado >> 7;
+		estado ^= estado << 17;
+		amostras[i] = pai[estado % num_vertices];
+	}
+
+	unsigned int frequente = amostras[0];
+	unsigned int maior_contagem = 0;
+	for (unsigned int i = 0; i < AMOSTRAS_AFFOREST; i++) {
+		unsigned int contagem = 0;
+
+		// Poucas amostras: a contagem quadratica e mais barata do que uma tabela
+		for (unsigned int j = i; j < AMOSTRAS_AFFOREST; j++) {
+			contagem += (amostras[j] == amostras[i]);
+		}
+		if (contagem > maior_contagem) {
+			maior_contagem = contagem;
+			frequente = amostras[i];
+		}
+	}
+
+	return frequente;
+}
+
+// Componentes de g com num_threads threads (Afforest): algumas rodadas ligam cada vertice a
+// poucos vizinhos, o que costuma juntar quase toda a componente gigante; depois so os vertices
+// fora dela examinam o resto da adjacencia. As raizes sao os menores vertices de cada componente,
+// entao os rotulos e ordem (em ordem crescente dentro de cada componente) nao dependem das threads
+// A bipartição fica para calcula_cores
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int componentes_paralelas(grafo *g, grafo_analise *a, unsigned int num_threads) {
+	size_t tamanho = g->num_vertices ? g->num_vertices : 1;
+	unsigned int *pai = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	a->componente = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	a->ordem = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	a->inicio_componente = (unsigned int*) malloc(sizeof(unsigned int) * ((size_t) g->num_vertices + 1));
+
+	if ((!pai) || (!a->componente) || (!a->ordem) || (!a->inicio_componente)) {
+		free(pai);
+		limpa_analise(a);
+		return 0;
+	}
+	CONTA(bytes_alocados, sizeof(unsigned int) * 4 * tamanho);
+
+	for (unsigned int v = 0; v < g->num_vertices; v++) {
+		pai[v] = v;
+	}
+
+	contexto_componentes ctx = {
+		.g = g,
+		.pai = pai,
+		.num_threads = num_threads,
+		.rodada = 0,
+		.componente_grande = UINT_MAX
+	};
+
+	for (ctx.rodada = 0; ctx.rodada < RODADAS_AFFOREST; ctx.rodada++) {
+		executa_paralelo(num_threads, trabalhador_componentes, &ctx);
+		executa_paralelo(num_threads, trabalhador_compressao, &ctx);
+	}
+
+	ctx.componente_grande = componente_frequente(pai, g->num_vertices);
+	executa_paralelo(num_threads, trabalhador_componentes, &ctx);
+	executa_paralelo(num_threads, trabalhador_compressao, &ctx);
+
+	// Rotulos na ordem das raizes; como pai[v] <= v, a raiz de v ja tem rotulo quando v e visto
+	unsigned int num_componentes = 0;
+	for (unsigned int v = 0; v < g->num_vertices; v++) {
+		a->componente[v] = (pai[v] == v) ? num_componentes++ : a->componente[pai[v]];
+	}
+
+	// ordem e preenchida por contagem, com os vertices de cada componente em ordem crescente
+	memset(a->inicio_componente, 0, sizeof(unsigned int) * ((size_t) num_componentes + 1));
+	for (unsigned int v = 0; v < g->num_vertices; v++) {
+		a->inicio_componente[a->componente[v] + 1]++;
+	}
+	for (unsigned int c = 0; c < num_componentes; c++) {
+		a->inicio_componente[c + 1] += a->inicio_componente[c];
+	}
+
+	// pai, ja sem uso, guarda a proxima posicao livre de cada componente
+	memcpy(pai, a->inicio_componente, sizeof(unsigned int) * num_componentes);
+	for (unsigned int v = 0; v < g->num_vertices; v++) {
+		a->ordem[pai[a->componente[v]]++] = v;
+	}
+	free(pai);
+
+	a->num_componentes = num_componentes;
+	a->tem_componentes = 1;
+	return 1;
+}
+
+// Confere se g e bipartido, pintando cada vertice com a paridade de seu nivel na busca em largura
+// Se as componentes vieram de componentes_paralelas, as cores ainda precisam dessa busca
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int calcula_cores(grafo *g, grafo_analise *a) {
+	unsigned int num_threads = threads_efetivas(g);
+
+	if (!a->cor) {
+		size_t tamanho = g->num_vertices ? g->num_vertices : 1;
+		unsigned char *cor = (unsigned char*) malloc(tamanho);
+		unsigned int *nivel = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+		unsigned int *ordem = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+		unsigned int *inicio_componente = (unsigned int*) malloc(sizeof(unsigned int) * ((size_t) g->num_vertices + 1));
+		unsigned int num_componentes;
+
+		if ((!cor) || (!nivel) || (!ordem) || (!inicio_componente) || (!busca_niveis(g, num_threads, nivel, NULL, ordem, inicio_componente, &num_componentes))) {
+			free(cor);
+			free(nivel);
+			free(ordem);
+			free(inicio_componente);
+			return 0;
+		}
+		CONTA(bytes_alocados, (3 * sizeof(unsigned int) + 1) * tamanho);
+
+		for (unsigned int v = 0; v < g->num_vertices; v++) {
+			cor[v] = (unsigned char) (nivel[v] & 1);
+		}
+		free(nivel);
+		free(ordem);
+		free(inicio_componente);
+		a->cor = cor;
+	}
+
+	a->bipartido = confere_cores(g, a->cor, num_threads);
+	a->tem_cores = 1;
+	return 1;
+}
+
+// Retorna a analise de g com as componentes calculadas (ou NULL em caso de erro)
+// Com mais de uma thread e grafos grandes, as componentes vem de componentes_paralelas;
+// senao, da busca por niveis, que ja deixa as cores prontas para bipartido
+grafo_analise *analise_componentes(grafo *g) {
+	grafo_analise *a = obtem_analise(g);
+	if (!a) {
+		return NULL;
+	}
+
+	if (a->tem_componentes) {
+		return a;
+	}
+
+	unsigned int num_threads = threads_efetivas(g);
+	if ((num_threads > 1) && (g->num_vertices >= MINIMO_VERTICES_COMPONENTES_PARALELAS)) {
+		return componentes_paralelas(g, a, num_threads) ? a : NULL;
+	}
+
+	return calcula_componentes(g, a) ? a : NULL;
+}
+
+// Retorna a analise de g com as componentes e a bipartição calculadas (ou NULL em caso de erro)
+grafo_analise *analise_bipartido(grafo *g) {
+	grafo_analise *a = analise_componentes(g);
+	if (!a) {
+		return NULL;
+	}
+
+	if ((!a->tem_cores) && (!calcula_cores(g, a))) {
+		return NULL;
+	}
+
+	return a;
+}
+
+// Retorna a analise de g com os vertices de corte e as pontes calculados (ou NULL em caso de erro)
+// Num grafo que ja recebeu insercoes, a primeira consulta cria os blocos incrementais junto com a
+// resposta; as seguintes leem a resposta deles, sem refazer a adjacencia nem percorrer as arestas
+grafo_analise *analise_cortes(grafo *g) {
+	grafo_analise *a = g->blocos ? analise_atual(g) : obtem_analise(g);
+	if (!a) {
+		return NULL;
+	}
+
+	if (!a->dados_cortes) {
+		unsigned int num_threads = threads_efetivas(g);
+
+		if (g->blocos) {
+			a->dados_cortes = cortes_dos_blocos(g);
+		} else if (g->conjuntos) {
+			g->blocos = cria_blocos(g);
+			a->dados_cortes = g->blocos ? cortes_paralelos(g, num_threads, g->blocos) : NULL;
+			if (!a->dados_cortes) {
+				destroi_blocos(g->blocos);
+				g->blocos = NULL;
+			}
+		} else if ((num_threads > 1) && (g->num_vertices >= MINIMO_VERTICES_CORTES_PARALELOS)) {
+			a->dados_cortes = cortes_paralelos(g, num_threads, NULL);
+		} else {
+			a->dados_cortes = calcula_cortes(g);
+		}
+
+		if ((a->dados_cortes) && (!ordena_cortes(g, a->dados_cortes))) {
+			destroi_cortes(a->dados_cortes);
+			a->dados_cortes = NULL;
+		}
+	}
+
+	return a->dados_cortes ? a : NULL;
+}
+
+// Retorna a analise de g com os cortes calculados e indexados (ou NULL em caso de erro)
+grafo_analise *analise_indice_cortes(grafo *g) {
+	grafo_analise *a = analise_cortes(g);
+	if ((a) && (!a->dados_cortes->no_arvore) && (!indexa_cortes(g, a->dados_cortes))) {
+		return NULL;
+	}
+
+	return a;
+}
+
+// Retorna a analise de g com os diametros das componentes calculados (ou NULL em caso de erro)
+grafo_analise *analise_diametros(grafo *g) {
+	grafo_analise *a = analise_componentes(g);
+	if (!a) {
+		return NULL;
+	}
+
+	if (a->diametros) {
+		return a;
+	}
+
+	uint64_t *diametros_componentes = (uint64_t*) calloc(a->num_componentes ? a->num_componentes : 1, sizeof(uint64_t));
+	if (!diametros_componentes) {
+		return NULL;
+	}
+
+	unsigned int num_threads = threads_efetivas(g);
+	unsigned int sucesso = 1;
+
+	// No modo exaustivo com todos os pesos 1, as buscas de cada componente saem de
+	// ORIGENS_MULTIPLA vertices por vez
+	if (g->modo_diametro == DIAMETRO_LIMITANTES) {
+		sucesso = diametros_por_limitantes(g, a->ordem, a->inicio_componente, a->num_componentes, diametros_componentes, num_threads);
+	} else if ((g->peso_minimo == 1) && (g->peso_maximo == 1)) {
+		sucesso = diametros_multiplos(g, a->ordem, a->inicio_componente, a->num_componentes, diametros_componentes, num_threads);
+	} else if (num_threads > 1) {
+		sucesso = excentricidades_paralelas(g, a->ordem, a->componente, diametros_componentes, num_threads);
+	} else {
+		memoria_sssp *mem = cria_memoria_sssp(g);
+
+		if (mem) {
+			for (unsigned int c = 0; c < a->num_componentes; c++) {
+				unsigned int tamanho_componente = a->inicio_componente[c + 1] - a->inicio_componente[c];
+				diametros_componentes[c] = diametro_componente(g, a->ordem + a->inicio_componente[c], tamanho_componente, mem);
+			}
+		} else {
+			sucesso = 0;
+		}
+
+		destroi_memoria_sssp(mem);
+	}
+
+	if (!sucesso) {
+		free(diametros_componentes);
+		return NULL;
+	}
+
+	qsort(diametros_componentes, a->num_componentes, sizeof(uint64_t), compara_uint64);
+	a->diametros = diametros_componentes;
+	return a;
+}
+
+// Ordem de Cuthill-McKee reversa dos vertices de g em ordem (ordem[i] e o vertice que vai para a
+// posicao i): cada componente e percorrida em largura a partir do seu vertice de menor grau, com os
+// vizinhos de cada vertice entrando na fila em ordem crescente de grau, e a ordem final e invertida
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int ordem_cuthill_mckee(grafo *g, unsigned int *ordem) {
+	unsigned int num_vertices = g->num_vertices;
+	size_t tamanho = num_vertices ? num_vertices : 1;
+	unsigned int *por_grau = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	unsigned char *visitado = (unsigned char*) calloc(tamanho, 1);
+	uint64_t *chaves = (uint64_t*) malloc(sizeof(uint64_t) * tamanho);
+
+	if ((!por_grau) || (!visitado) || (!chaves)) {
+		free(por_grau);
+		free(visitado);
+		free(chaves);
+		return 0;
+	}
+	CONTA(bytes_alocados, (sizeof(unsigned int) + 1 + sizeof(uint64_t)) * tamanho);
+
+	// Vertices em ordem crescente de grau (e de indice, nos empates), candidatos a inicio de componente
+	for (unsigned int v = 0; v < num_vertices; v++) {
+		chaves[v] = ((uint64_t) (g->inicio_adj[v + 1] - g->inicio_adj[v]) << 32) | v;
+	}
+	qsort(chaves, num_vertices, sizeof(uint64_t), compara_uint64);
+	for (unsigned int i = 0; i < num_vertices; i++) {
+		por_grau[i] = (unsigned int) chaves[i];
+	}
+
+	unsigned int fim = 0;
+	for (unsigned int i = 0; i < num_vertices; i++) {
+		if (visitado[por_grau[i]]) {
+			continue;
+		}
+
+		unsigned int inicio = fim;
+		ordem[fim++] = por_grau[i];
+		visitado[por_grau[i]] = 1;
+
+		while (inicio < fim) {
+			unsigned int u = ordem[inicio++];
+			unsigned int novos = 0;
+
+			CONTA(arestas_examinadas, g->inicio_adj[u + 1] - g->inicio_adj[u]);
+			for (unsigned int j = g->inicio_adj[u]; j < g->inicio_adj[u + 1]; j++) {
+				unsigned int w = g->vizinhos[j];
+
+				if (!visitado[w]) {
+					visitado[w] = 1;
+					chaves[novos++] = ((uint64_t) (g->inicio_adj[w + 1] - g->inicio_adj[w]) << 32) | w;
+				}
+			}
+
+			qsort(chaves, novos, sizeof(uint64_t), compara_uint64);
+			for (unsigned int k = 0; k < novos; k++) {
+				ordem[fim++] = (unsigned int) chaves[k];
+			}
+		}
+	}
+	CONTA(vertices_visitados, num_vertices);
+
+	for (unsigned int i = 0; i < num_vertices / 2; i++) {
+		unsigned int troca = ordem[i];
+		ordem[i] = ordem[num_vertices - 1 - i];
+		ordem[num_vertices - 1 - i] = troca;
+	}
+
+	free(por_grau);
+	free(visitado);
+	free(chaves);
+	return 1;
+}
+
+// Ordem dos vertices de g na busca em largura por niveis: componente por componente, cada uma
+// a partir do seu menor vertice, e nivel por nivel
+// A busca usa uma thread so: com varias, a ordem dentro de cada nivel depende de qual thread
+// chega primeiro, e a numeracao dos vertices mudaria de uma execucao para outra
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int ordem_largura(grafo *g, unsigned int *ordem) {
+	size_t tamanho = g->num_vertices ? g->num_vertices : 1;
+	unsigned int *nivel = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	unsigned int *inicio_componente = (unsigned int*) malloc(sizeof(unsigned int) * (tamanho + 1));
+	unsigned int num_componentes;
+
+	unsigned int sucesso = (nivel) && (inicio_componente) &&
+	                       (busca_niveis(g, 1, nivel, NULL, ordem, inicio_componente, &num_componentes));
+
+	free(nivel);
+	free(inicio_componente);
+	return sucesso;
+}
+
+// Ordem dos vertices de g por grau decrescente (e por indice, nos empates), com os vertices de
+// maior grau juntos no comeco, numa ordenacao por contagem
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int ordem_grau(grafo *g, unsigned int *ordem) {
+	unsigned int num_vertices = g->num_vertices;
+	unsigned int grau_maximo = 0;
+	for (unsigned int v = 0; v < num_vertices; v++) {
+		unsigned int grau = g->inicio_adj[v + 1] - g->inicio_adj[v];
+		grau_maximo = grau > grau_maximo ? grau : grau_maximo;
+	}
+
+	unsigned int *contagem = (unsigned int*) calloc((size_t) grau_maximo + 2, sizeof(unsigned int));
+	if (!contagem) {
+		return 0;
+	}
+
+	// A contagem e feita sobre grau_maximo - grau, para que a ordem seja decrescente
+	for (unsigned int v = 0; v < num_vertices; v++) {
+		contagem[grau_maximo - (g->inicio_adj[v + 1] - g->inicio_adj[v]) + 1]++;
+	}
+	for (unsigned int i = 0; i <= grau_maximo; i++) {
+		contagem[i + 1] += contagem[i];
+	}
+	for (unsigned int v = 0; v < num_vertices; v++) {
+		ordem[contagem[grau_maximo - (g->inicio_adj[v + 1] - g->inicio_adj[v])]++] = v;
+	}
+
+	free(contagem);
+	return 1;
+}
+
+// Renumera os vertices de g: o vertice ordem[i] passa a ser o vertice i
+// Vertices, tabela hash e adjacencia sao permutados (os vizinhos de cada vertice mantem sua ordem),
+// e tudo o que depende dos indices e descartado: a analise, os postos dos nomes, os conjuntos
+// disjuntos e os blocos incrementais, refeitos sob demanda
+// Retorna 1 em caso de sucesso e 0 em caso de erro (g nao muda)
+unsigned int aplica_ordem(grafo *g, const unsigned int *ordem) {
+	unsigned int num_vertices = g->num_vertices;
+	size_t total = g->inicio_adj[num_vertices];
+	unsigned int *nova = (unsigned int*) malloc(sizeof(unsigned int) * (num_vertices ? num_vertices : 1));
+	vertice *vertices = (vertice*) malloc(sizeof(vertice) * (g->capacidade_vertices ? g->capacidade_vertices : 1));
+	unsigned int *inicio = (unsigned int*) malloc(sizeof(unsigned int) * ((size_t) num_vertices + 1));
+	unsigned int *vizinhos = (unsigned int*) malloc(sizeof(unsigned int) * (total ? total : 1));
+	unsigned int *pesos = (unsigned int*) malloc(sizeof(unsigned int) * (total ? total : 1));
+
+	if ((!nova) || (!vertices) || (!inicio) || (!vizinhos) || (!pesos)) {
+		free(nova);
+		free(vertices);
+		free(inicio);
+		free(vizinhos);
+		free(pesos);
+		return 0;
+	}
+	CONTA(bytes_alocados, sizeof(unsigned int) * ((size_t) 2 * num_vertices + 1 + 2 * total) + sizeof(vertice) * g->capacidade_vertices);
+
+	for (unsigned int i = 0; i < num_vertices; i++) {
+		nova[ordem[i]] = i;
+	}
+
+	inicio[0] = 0;
+	for (unsigned int i = 0; i < num_vertices; i++) {
+		unsigned int v = ordem[i];
+		unsigned int posicao = inicio[i];
+
+		vertices[i] = g->vertices[v];
+		for (unsigned int j = g->inicio_adj[v]; j < g->inicio_adj[v + 1]; j++) {
+			vizinhos[posicao] = nova[g->vizinhos[j]];
+			pesos[posicao] = g->pesos[j];
+			posicao++;
+		}
+		inicio[i + 1] = posicao;
+	}
+	CONTA(arestas_examinadas, total);
+
+	for (unsigned int i = 0; i < g->capacidade_hash; i++) {
+		if (g->tabela_hash[i] != HASH_VAZIO) {
+			g->tabela_hash[i] = nova[g->tabela_hash[i]];
+		}
+	}
+
+	free(nova);
+	free(g->vertices);
+	free(g->inicio_adj);
+	free(g->vizinhos);
+	free(g->pesos);
+	g->vertices = vertices;
+	g->inicio_adj = inicio;
+	g->vizinhos = vizinhos;
+	g->pesos = pesos;
+
+	free(g->posto_nome);
+	free(g->ordem_nomes);
+	g->posto_nome = NULL;
+	g->ordem_nomes = NULL;
+	g->vertices_postos = 0;
+	destroi_conjuntos(g->conjuntos);
+	g->conjuntos = NULL;
+	destroi_blocos(g->blocos);
+	g->blocos = NULL;
+	g->versao++;
+	return 1;
+}
+
+// Desaloca os conjuntos disjuntos c
+void destroi_conjuntos(uniao_busca *c) {
+	if (!c) {
+		return;
+	}
+
+	free(c->pai);
+	free(c->rank);
+	free(c->paridade);
+	free(c->tamanho);
+	free(c);
+}
+
+// Garante espaco em c para pelo menos capacidade elementos (crescendo por duplicacao)
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int reserva_conjuntos(uniao_busca *c, unsigned int capacidade) {
+	if (capacidade <= c->capacidade) {
+		return 1;
+	}
+
+	unsigned int nova_capacidade = c->capacidade ? c->capacidade : 64;
+	while (nova_capacidade < capacidade) {
+		nova_capacidade *= 2;
+	}
+
+	unsigned int *pai = realloc(c->pai, sizeof(unsigned int) * nova_capacidade);
+	if (!pai) {
+		return 0;
+	}
+	c->pai = pai;
+
+	unsigned char *rank = realloc(c->rank, nova_capacidade);
+	if (!rank) {
+		return 0;
+	}
+	c->rank = rank;
+
+	unsigned char *paridade = realloc(c->paridade, nova_capacidade);
+	if (!paridade) {
+		return 0;
+	}
+	c->paridade = paridade;
+
+	unsigned int *tamanho = realloc(c->tamanho, sizeof(unsigned int) * nova_capacidade);
+	if (!tamanho) {
+		return 0;
+	}
+	c->tamanho = tamanho;
+
+	c->capacidade = nova_capacidade;
+	return 1;
+}
+
+// Cria um conjunto unitario para cada vertice de indice num_elementos .. num_vertices-1
+// O espaco ja deve ter sido reservado (reserva_conjuntos)
+void acompanha_vertices(uniao_busca *c, unsigned int num_vertices) {
+	for (unsigned int v = c->num_elementos; v < num_vertices; v++) {
+		c->pai[v] = v;
+		c->rank[v] = 0;
+		c->paridade[v] = 0;
+		c->tamanho[v] = 1;
+		c->num_conjuntos++;
+	}
+
+	if (num_vertices > c->num_elementos) {
+		c->num_elementos = num_vertices;
+	}
+}
+
+// Retorna a raiz do conjunto de x e guarda em paridade a paridade do caminho de x ate ela
+// O caminho e comprimido numa segunda passada, sem recursao
+unsigned int busca_conjunto(uniao_busca *c, unsigned int x, unsigned char *paridade) {
+	unsigned int raiz = x;
+	unsigned char paridade_x = 0;
+
+	while (c->pai[raiz] != raiz) {
+		paridade_x ^= c->paridade[raiz];
+		raiz = c->pai[raiz];
+	}
+
+	// Cada vertice do caminho passa a apontar direto para a raiz, com a paridade ate ela
+	unsigned int atual = x;
+	unsigned char paridade_atual = paridade_x;
+	while (c->pai[atual] != raiz) {
+		unsigned int proximo = c->pai[atual];
+		unsigned char paridade_proximo = paridade_atual ^ c->paridade[atual];
+
+		c->pai[atual] = raiz;
+		c->paridade[atual] = paridade_atual;
+		atual = proximo;
+		paridade_atual = paridade_proximo;
+	}
+
+	*paridade = paridade_x;
+	return raiz;
+}
+
+// Registra a aresta u -- v: une os conjuntos de u e v de modo que suas paridades fiquem
+// diferentes; se ja estao no mesmo conjunto com a mesma paridade, a aresta fecha um ciclo impar
+void une_conjuntos(uniao_busca *c, unsigned int u, unsigned int v) {
+	unsigned char paridade_u, paridade_v;
+	unsigned int raiz_u = busca_conjunto(c, u, &paridade_u);
+	unsigned int raiz_v = busca_conjunto(c, v, &paridade_v);
+
+	if (raiz_u == raiz_v) {
+		if (paridade_u == paridade_v) {
+			c->bipartido = 0;
+		}
+		return;
+	}
+
+	if (c->rank[raiz_u] < c->rank[raiz_v]) {
+		unsigned int troca = raiz_u;
+		raiz_u = raiz_v;
+		raiz_v = troca;
+	} else if (c->rank[raiz_u] == c->rank[raiz_v]) {
+		c->rank[raiz_u]++;
+	}
+
+	c->pai[raiz_v] = raiz_u;
+	c->paridade[raiz_v] = (unsigned char) (paridade_u ^ paridade_v ^ 1);
+	c->tamanho[raiz_u] += c->tamanho[raiz_v];
+	c->num_conjuntos--;
+}
+
+// Cria os conjuntos disjuntos de g a partir das componentes e das cores da busca em largura:
+// o primeiro vertice de cada componente e a raiz e a paridade de cada vertice e sua cor
+// Retorna NULL em caso de erro
+uniao_busca *cria_conjuntos(grafo *g) {
+	grafo_analise *a = analise_bipartido(g);
+	if (!a) {
+		return NULL;
+	}
+
+	uniao_busca *c = (uniao_busca*) calloc(1, sizeof(uniao_busca));
+	if ((!c) || (!reserva_conjuntos(c, g->num_vertices))) {
+		destroi_conjuntos(c);
+		return NULL;
+	}
+
+	for (unsigned int comp = 0; comp < a->num_componentes; comp++) {
+		unsigned int raiz = a->ordem[a->inicio_componente[comp]];
+
+		for (unsigned int i = a->inicio_componente[comp]; i < a->inicio_componente[comp + 1]; i++) {
+			unsigned int v = a->ordem[i];
+			c->pai[v] = raiz;
+			c->rank[v] = 0;
+			c->paridade[v] = (unsigned char) (a->cor[v] ^ a->cor[raiz]);
+		}
+		c->rank[raiz] = 1;
+		c->tamanho[raiz] = a->inicio_componente[comp + 1] - a->inicio_componente[comp];
+	}
+
+	c->num_elementos = g->num_vertices;
+	c->num_conjuntos = a->num_componentes;
+	c->bipartido = a->bipartido;
+	return c;
+}
+
+// Desaloca os blocos incrementais b
+void destroi_blocos(blocos_incrementais *b) {
+	if (!b) {
+		return;
+	}
+
+	free(b->pai);
+	free(b->profundidade);
+	free(b->primeiro_filho);
+	free(b->proximo_irmao);
+	free(b->irmao_anterior);
+	free(b->aresta);
+	free(b->num_topos);
+	free(b->caminho);
+	free(b->pai_bloco);
+	free(b->topo);
+	free(b->tamanho_bloco);
+	free(b);
+}
+
+// Garante espaco em b para pelo menos capacidade vertices e o dobro de elementos (crescendo por
+// duplicacao): cada aresta que liga duas arvores cria um elemento, entao nunca faltam elementos
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int reserva_blocos(blocos_incrementais *b, unsigned int capacidade) {
+	if (capacidade <= b->capacidade) {
+		return 1;
+	}
+
+	unsigned int nova_capacidade = b->capacidade ? b->capacidade : 64;
+	while (nova_capacidade < capacidade) {
+		nova_capacidade *= 2;
+	}
+
+	unsigned int **vetores[] = {
+		&b->pai, &b->profundidade, &b->primeiro_filho, &b->proximo_irmao, &b->irmao_anterior,
+		&b->aresta, &b->num_topos, &b->caminho, &b->pai_bloco, &b->topo, &b->tamanho_bloco
+	};
+	unsigned int num_vetores = sizeof(vetores) / sizeof(vetores[0]);
+
+	// Os tres ultimos vetores sao indexados por elemento
+	for (unsigned int i = 0; i < num_vetores; i++) {
+		size_t tamanho = (i + 3 < num_vetores) ? nova_capacidade : 2 * (size_t) nova_capacidade;
+		unsigned int *vetor = realloc(*vetores[i], sizeof(unsigned int) * tamanho);
+		if (!vetor) {
+			return 0;
+		}
+		*vetores[i] = vetor;
+	}
+
+	b->capacidade = nova_capacidade;
+	return 1;
+}
+
+// Cria uma arvore de um vertice so para cada vertice de indice b->num_vertices .. num_vertices-1
+// O espaco ja deve ter sido reservado (reserva_blocos)
+void acompanha_blocos(blocos_incrementais *b, unsigned int num_vertices) {
+	for (unsigned int v = b->num_vertices; v < num_vertices; v++) {
+		b->pai[v] = UINT_MAX;
+		b->profundidade[v] = 0;
+		b->primeiro_filho[v] = UINT_MAX;
+		b->proximo_irmao[v] = UINT_MAX;
+		b->irmao_anterior[v] = UINT_MAX;
+		b->aresta[v] = UINT_MAX;
+		b->num_topos[v] = 0;
+	}
+
+	if (num_vertices > b->num_vertices) {
+		b->num_vertices = num_vertices;
+	}
+}
+
+// Cria os blocos incrementais de g, ainda vazios (cortes_paralelos os preenche)
+// Retorna NULL em caso de erro
+blocos_incrementais *cria_blocos(grafo *g) {
+	blocos_incrementais *b = (blocos_incrementais*) calloc(1, sizeof(blocos_incrementais));
+	if ((!b) || (!reserva_blocos(b, g->num_vertices + 2))) {
+		destroi_blocos(b);
+		return NULL;
+	}
+
+	CONTA(bytes_alocados, sizeof(unsigned int) * 14 * (size_t) b->capacidade);
+	return b;
+}
+
+// Preenche b com a floresta pai dos num_vertices vertices (com as profundidades ja em
+// b->profundidade) e com as classes comprimidas da uniao-busca de cortes_paralelos, em que o
+// elemento da aresta v -- pai[v] e v
+void inicia_blocos(blocos_incrementais *b, unsigned int num_vertices, const unsigned int *pai, const unsigned int *classe) {
+	for (unsigned int v = 0; v < num_vertices; v++) {
+		b->pai[v] = UINT_MAX;
+		b->primeiro_filho[v] = UINT_MAX;
+		b->proximo_irmao[v] = UINT_MAX;
+		b->irmao_anterior[v] = UINT_MAX;
+		b->aresta[v] = UINT_MAX;
+		b->num_topos[v] = 0;
+		b->pai_bloco[v] = v;
+		b->tamanho_bloco[v] = 0;
+		b->topo[v] = UINT_MAX;
+	}
+	b->num_vertices = num_vertices;
+	b->num_elementos = num_vertices;
+
+	for (unsigned int v = 0; v < num_vertices; v++) {
+		if (pai[v] == UINT_MAX) {
+			continue;
+		}
+
+		unsigned int bloco = classe[v];
+		b->pai[v] = pai[v];
+		b->aresta[v] = v;
+		b->pai_bloco[v] = bloco;
+		b->tamanho_bloco[bloco]++;
+		adiciona_filho(b, pai[v], v);
+
+		if ((b->topo[bloco] == UINT_MAX) || (b->profundidade[pai[v]] < b->profundidade[b->topo[bloco]])) {
+			b->topo[bloco] = pai[v];
+		}
+	}
+
+	for (unsigned int v = 0; v < num_vertices; v++) {
+		if ((b->pai[v] != UINT_MAX) && (b->pai_bloco[v] == v)) {
+			b->num_topos[b->topo[v]]++;
+		}
+	}
+}
+
+// Retorna a raiz da classe do elemento x, comprimindo o caminho numa segunda passada
+unsigned int busca_bloco(blocos_incrementais *b, unsigned int x) {
+	unsigned int raiz = x;
+	while (b->pai_bloco[raiz] != raiz) {
+		raiz = b->pai_bloco[raiz];
+	}
+
+	while (b->pai_bloco[x] != raiz) {
+		unsigned int proximo = b->pai_bloco[x];
+		b->pai_bloco[x] = raiz;
+		x = proximo;
+	}
+
+	return raiz;
+}
+
+// Une os blocos de raizes x e y (uniao por tamanho) e retorna a raiz do resultado, cujo topo
+// e o mais alto dos dois
+unsigned int une_blocos(blocos_incrementais *b, unsigned int x, unsigned int y) {
+	unsigned int topo_x = b->topo[x];
+	unsigned int topo_y = b->topo[y];
+	unsigned int topo = (b->profundidade[topo_y] < b->profundidade[topo_x]) ? topo_y : topo_x;
+
+	b->num_topos[topo_x]--;
+	b->num_topos[topo_y]--;
+	b->num_topos[topo]++;
+
+	if (b->tamanho_bloco[x] < b->tamanho_bloco[y]) {
+		unsigned int troca = x;
+		x = y;
+		y = troca;
+	}
+
+	b->pai_bloco[y] = x;
+	b->tamanho_bloco[x] += b->tamanho_bloco[y];
+	b->topo[x] = topo;
+	return x;
+}
+
+// Poe v no comeco da lista de filhos de p
+void adiciona_filho(blocos_incrementais *b, unsigned int p, unsigned int v) {
+	b->irmao_anterior[v] = UINT_MAX;
+	b->proximo_irmao[v] = b->primeiro_filho[p];
+	if (b->primeiro_filho[p] != UINT_MAX) {
+		b->irmao_anterior[b->primeiro_filho[p]] = v;
+	}
+	b->primeiro_filho[p] = v;
+}
+
+// Tira v da lista de filhos de p
+void remove_filho(blocos_incrementais *b, unsigned int p, unsigned int v) {
+	if (b->irmao_anterior[v] != UINT_MAX) {
+		b->proximo_irmao[b->irmao_anterior[v]] = b->proximo_irmao[v];
+	} else {
+		b->primeiro_filho[p] = b->proximo_irmao[v];
+	}
+
+	if (b->proximo_irmao[v] != UINT_MAX) {
+		b->irmao_anterior[b->proximo_irmao[v]] = b->irmao_anterior[v];
+	}
+}
+
+// Torna v a raiz da sua arvore, invertendo as arestas do caminho de v ate a raiz antiga
+// Os blocos nao mudam; so os que tem arestas no caminho mudam de topo, que passa a ser a ponta
+// do seu trecho de caminho mais proxima de v. As profundidades sao refeitas por liga_blocos
+void reenraiza_blocos(blocos_incrementais *b, unsigned int v) {
+	unsigned int tamanho_caminho = 0;
+	for (unsigned int x = v; x != UINT_MAX; x = b->pai[x]) {
+		b->caminho[tamanho_caminho++] = x;
+	}
+	CONTA(vertices_visitados, tamanho_caminho);
+
+	// As arestas de um bloco formam um trecho contiguo do caminho
+	unsigned int bloco_anterior = UINT_MAX;
+	for (unsigned int i = 0; i + 1 < tamanho_caminho; i++) {
+		unsigned int x = b->caminho[i];
+		unsigned int bloco = busca_bloco(b, b->aresta[x]);
+
+		if (bloco != bloco_anterior) {
+			b->num_topos[b->topo[bloco]]--;
+			b->topo[bloco] = x;
+			b->num_topos[x]++;
+			bloco_anterior = bloco;
+		}
+	}
+
+	// Cada aresta do caminho passa a ser representada pela ponta que era o pai
+	for (unsigned int i = tamanho_caminho - 1; i > 0; i--) {
+		unsigned int x = b->caminho[i - 1];
+		unsigned int p = b->caminho[i];
+
+		remove_filho(b, p, x);
+		b->pai[p] = x;
+		b->aresta[p] = b->aresta[x];
+		adiciona_filho(b, x, p);
+	}
+
+	b->pai[v] = UINT_MAX;
+	b->aresta[v] = UINT_MAX;
+}
+
+// Pendura a arvore de raiz v em u pela aresta u -- v, que forma um bloco sozinha, e refaz as
+// profundidades da arvore de v
+void liga_blocos(blocos_incrementais *b, unsigned int u, unsigned int v) {
+	unsigned int elemento = b->num_elementos++;
+	b->pai_bloco[elemento] = elemento;
+	b->tamanho_bloco[elemento] = 1;
+	b->topo[elemento] = u;
+	b->num_topos[u]++;
+
+	b->pai[v] = u;
+	b->aresta[v] = elemento;
+	adiciona_filho(b, u, v);
+
+	// Busca em largura pelas listas de filhos, usando caminho como fila
+	unsigned int inicio = 0;
+	unsigned int fim = 0;
+	b->caminho[fim++] = v;
+	while (inicio < fim) {
+		unsigned int x = b->caminho[inicio++];
+		b->profundidade[x] = b->profundidade[b->pai[x]] + 1;
+
+		for (unsigned int filho = b->primeiro_filho[x]; filho != UINT_MAX; filho = b->proximo_irmao[filho]) {
+			b->caminho[fim++] = filho;
+		}
+	}
+	CONTA(vertices_visitados, fim);
+}
+
+// Une num so bloco os blocos do caminho de u ate v na floresta (a aresta u -- v fecha um ciclo)
+// Sobe sempre pela ponta mais funda, pulando de cada bloco direto para o seu topo; como todo bloco
+// visitado e unido aos outros, o custo amortizado por aresta e quase constante
+void fecha_ciclo_blocos(blocos_incrementais *b, unsigned int u, unsigned int v) {
+	unsigned int unido = UINT_MAX;
+
+	while (u != v) {
+		if (b->profundidade[u] < b->profundidade[v]) {
+			unsigned int troca = u;
+			u = v;
+			v = troca;
+		}
+
+		unsigned int bloco = busca_bloco(b, b->aresta[u]);
+		if (bloco == unido) {
+			// A aresta de u ja foi unida: o bloco unido vai de u ate o seu topo
+			u = b->topo[unido];
+			continue;
+		}
+
+		unsigned int topo = b->topo[bloco];
+		unido = (unido == UINT_MAX) ? bloco : une_blocos(b, unido, bloco);
+		u = topo;
+		CONTA(vertices_visitados, 1);
+	}
+}
+
+// Atualiza os blocos de g com a aresta u -- v; deve ser chamada antes de une_conjuntos, que diz se
+// u e v ja estavam na mesma arvore
+// Arestas entre arvores diferentes reenraizam a menor delas (o que da O(log n) reenraizamentos
+// amortizados por vertice); laços e copias de arestas da floresta nao mudam os blocos
+void insere_aresta_blocos(grafo *g, unsigned int u, unsigned int v) {
+	blocos_incrementais *b = g->blocos;
+	uniao_busca *c = g->conjuntos;
+	unsigned char paridade;
+
+	if ((u == v) || (b->pai[u] == v) || (b->pai[v] == u)) {
+		return;
+	}
+
+	unsigned int raiz_u = busca_conjunto(c, u, &paridade);
+	unsigned int raiz_v = busca_conjunto(c, v, &paridade);
+	if (raiz_u == raiz_v) {
+		fecha_ciclo_blocos(b, u, v);
+		return;
+	}
+
+	if (c->tamanho[raiz_v] > c->tamanho[raiz_u]) {
+		unsigned int troca = u;
+		u = v;
+		v = troca;
+	}
+
+	reenraiza_blocos(b, v);
+	liga_blocos(b, u, v);
+}
+
+// Vertices de corte e pontes de g lidos dos blocos incrementais, sem percorrer as arestas
+// pai e bloco recebem a floresta e os blocos de suas arestas
+// Retorna NULL em caso de erro
+cortes *cortes_dos_blocos(grafo *g) {
+	blocos_incrementais *b = g->blocos;
+	size_t tamanho = g->num_vertices ? g->num_vertices : 1;
+	cortes *c = (cortes*) calloc(1, sizeof(cortes));
+	if (!c) {
+		return NULL;
+	}
+
+	c->eh_corte = (unsigned int*) calloc(tamanho, sizeof(unsigned int));
+	c->pontes = (unsigned int*) malloc(sizeof(unsigned int) * 2 * tamanho);
+	c->pai = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	c->bloco = (unsigned int*) malloc(sizeof(unsigned int) * tamanho);
+	unsigned int *vertice_do_bloco = (unsigned int*) malloc(sizeof(unsigned int) * (b->num_elementos ? b->num_elementos : 1));
+	if ((!c->eh_corte) || (!c->pontes) || (!c->pai) || (!c->bloco) || (!vertice_do_bloco)) {
+		free(vertice_do_bloco);
+		destroi_cortes(c);
+		return NULL;
+	}
+	CONTA(bytes_alocados, sizeof(unsigned int) * 5 * tamanho);
+	CONTA(vertices_visitados, g->num_vertices);
+
+	// Cada bloco passa a ser identificado pelo primeiro vertice cuja aresta para o pai esta nele
+	for (unsigned int i = 0; i < b->num_elementos; i++) {
+		vertice_do_bloco[i] = UINT_MAX;
+	}
+
+	memcpy(c->pai, b->pai, sizeof(unsigned int) * g->num_vertices);
+	for (unsigned int v = 0; v < g->num_vertices; v++) {
+		unsigned int p = b->pai[v];
+
+		c->eh_corte[v] = (b->num_topos[v] >= ((p != UINT_MAX) ? 1u : 2u));
+		if (p == UINT_MAX) {
+			continue;
+		}
+
+		unsigned int bloco = busca_bloco(b, b->aresta[v]);
+		if (vertice_do_bloco[bloco] == UINT_MAX) {
+			vertice_do_bloco[bloco] = v;
+		}
+		c->bloco[v] = vertice_do_bloco[bloco];
+
+		if (b->tamanho_bloco[bloco] == 1) {
+			c->pontes[2 * c->num_pontes] = p;
+			c->pontes[2 * c->num_pontes + 1] = v;
+			c->num_pontes++;
+		}
+	}
+
+	free(vertice_do_bloco);
+	return c;
+}
+
+// Prepara g para receber um vertice ou uma aresta: tira o grafo do mapa, cria os conjuntos
+// disjuntos na primeira insercao e reserva espaco neles (e nos blocos incrementais, se existem)
+// para ate dois vertices novos
+// Retorna 1 em caso de sucesso e 0 em caso de erro
+unsigned int prepara_insercao(grafo *g) {
+	if (!materializa_grafo(g)) {
+		return 0;
+	}
+
+	if (!g->conjuntos) {
+		g->conjuntos = cria_conjuntos(g);
+		if (!g->conjuntos) {
+			return 0;
+		}
+	}
+
+	if ((g->blocos) && (!reserva_blocos(g->blocos, g->num_vertices + 2))) {
+		return 0;
+	}
+
+	return reserva_conjuntos(g->conjuntos, g->num_vertices + 2);
+}
+
+// Retorna uma nova string vazia
+char *string_vazia(void) {
+	char *resposta = malloc(1);
+	if (resposta) {
+		resposta[0] = '\0';
+	}
+
+	return resposta;
+}
+
+// Retorna uma nova string com os nomes dos vertices ids[0 .. quantidade-1], nessa ordem e separados
+// por brancos (o formato de vertices_corte e arestas_corte), ou NULL em caso de erro
+// Mede a resposta antes, para uma unica alocacao
+char *junta_nomes(grafo *g, const unsigned int *ids, unsigned int quantidade) {
+	size_t tamanho_total = 1;
+	for (unsigned int i = 0; i < quantidade; i++) {
+		tamanho_total += strlen(g->vertices[ids[i]].nome) + 1;
+	}
+
+	char *resultado = malloc(tamanho_total);
+	if (!resultado) {
+		return NULL;
+	}
+
+	char *ptr = resultado;
+	for (unsigned int i = 0; i < quantidade; i++) {
+		const char *nome_atual = g->vertices[ids[i]].nome;
+		size_t len = strlen(nome_atual);
+		if (i > 0) {
+			*ptr++ = ' ';
+		}
+		memcpy(ptr, nome_atual, len);
+		ptr += len;
+	}
+	*ptr = '\0';
+
+	return resultado;
+}
+
+// Função de comparação para ordenação alfabética
+int compara_nome_vertices(const void *a, const void *b) {
+	return strcmp(*(const char * const*)a, *(const char * const *)b);
+}
+
+// Função de comparação para ordenação não decrescente de diametros
+int compara_uint64(const void *a, const void *b) {
+	uint64_t da = *(const uint64_t *)a;
+	uint64_t db = *(const uint64_t *)b;
+
+	return ((da > db) - (da < db));
+}
+
+#ifdef GRAFO_STATS
+// Retorna o tempo atual em segundos
+double relogio(void) {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return (double) t.tv_sec + (double) t.tv_nsec / 1e9;
+}
+
+// Soma os contadores da thread atual as estatisticas de g e os zera
+// As somas sao atomicas porque os trabalhadores de uma mesma funcao terminam ao mesmo tempo
+void junta_contadores(grafo *g) {
+	estatisticas_grafo *e = &g->estatisticas;
+
+	__atomic_fetch_add(&e->vertices_visitados, contadores_da_thread.vertices_visitados, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&e->arestas_examinadas, contadores_da_thread.arestas_examinadas, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&e->execucoes_sssp, contadores_da_thread.execucoes_sssp, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&e->operacoes_fila, contadores_da_thread.operacoes_fila, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&e->bytes_alocados, contadores_da_thread.bytes_alocados, __ATOMIC_RELAXED);
+	memset(&contadores_da_thread, 0, sizeof(contadores));
+}
+
+// Comeca a medicao de funcao sobre g (que pode ainda nao existir)
+medicao inicia_medicao(grafo *g, funcao_estatistica funcao) {
+	medicao m = { .g = g, .funcao = funcao, .inicio = relogio() };
+
+	memset(&contadores_da_thread, 0, sizeof(contadores));
+	return m;
+}
+
+// Termina a medicao m: soma o tempo decorrido e os contadores da thread ao grafo
+void termina_medicao(medicao *m) {
+	if (!m->g) {
+		return;
+	}
+
+	m->g->estatisticas.segundos[m->funcao] += relogio() - m->inicio;
+	m->g->estatisticas.chamadas[m->funcao]++;
+	junta_contadores(m->g);
+}
+#endif
+/* -------------------------- FUNÇÕES DA BIBLIOTECA -------------------------- */
+// lê um grafo de f e o devolve
+grafo *le_grafo(FILE *f) {
+	ESTATISTICA(medicao medicao_funcao = inicia_medicao(NULL, ESTAT_LE_GRAFO);)
+	grafo *grafo_lido = cria_grafo_vazio();
+	if (!grafo_lido) {
+		printf("[le_grafo] erro em malloc.\n");
+		return NULL;
+	}
+
+	// Arquivos comuns sao mapeados em memoria; pipes e terminais sao lidos em blocos
+	lista_arestas *lidas = &grafo_lido->pendentes;
+	if ((!le_arquivo_mapeado(f, grafo_lido, lidas)) && (!le_em_blocos(f, grafo_lido, lidas))) {
+		printf("[le_grafo] erro em malloc.\n");
+		destroi_grafo(grafo_lido);
+		return NULL;
+	}
+
+	grafo_lido->num_arestas = lidas->tamanho;
+
+	// Adjacencia e montada uma unica vez, depois de lidas todas as arestas
+	if (!constroi_adjacencia(grafo_lido)) {
+		printf("[le_grafo] erro em malloc.\n");
+		destroi_grafo(grafo_lido);
+		return NULL;
+	}
+
+	ESTATISTICA(medicao_funcao.g = grafo_lido; termina_medicao(&medicao_funcao);)
+	return grafo_lido;
+}
+
+// lê um grafo de f usando num_threads threads e o devolve
+grafo *le_grafo_paralelo(FILE *f, unsigned int num_threads) {
+	ESTATISTICA(medicao medicao_funcao = inicia_medicao(NULL, ESTAT_LE_GRAFO_PARALELO);)
+	grafo *grafo_lido = cria_grafo_vazio();
+	if (!grafo_lido) {
+		printf("[le_grafo_paralelo] erro em malloc.\n");
+		return NULL;
+	}
+	grafo_lido->num_threads = num_threads;
+
+	size_t tamanho, tamanho_mapa;
+	char *entrada = le_entrada_inteira(f, &tamanho, &tamanho_mapa);
+	if (!entrada) {
+		printf("[le_grafo_paralelo] erro em malloc.\n");
+		destroi_grafo(grafo_lido);
+		return NULL;
+	}
+
+	// O nome do grafo (primeira linha nao ignorada) e achado antes da divisao em pedacos
+	const char *p = entrada;
+	const char *fim = entrada + tamanho;
+	while ((p < fim) && (!grafo_lido->nome)) {
+		const char *quebra = (const char*) memchr(p, '\n', (size_t) (fim - p));
+		if (!quebra) {
+			quebra = fim;
+		}
+
+		linha_lida lida;
+		if (interpreta_linha(p, (size_t) (quebra - p), &lida) != LINHA_IGNORADA) {
+			grafo_lido->nome = copia_str(&grafo_lido->nomes, p, (size_t) (quebra - p));
+			if (!grafo_lido->nome) {
+				exit(-1);
+			}
+		}
+		p = (quebra < fim) ? quebra + 1 : fim;
+	}
+
+	// Divide o restante em pedacos de tamanhos parecidos, terminados em fim de linha
+	unsigned int num_pedacos = threads_efetivas(grafo_lido);
+	size_t maximo_pedacos = (size_t) (fim - p) / TAMANHO_MINIMO_PEDACO + 1;
+	if (num_pedacos > maximo_pedacos) {
+		num_pedacos = (unsigned int) maximo_pedacos;
+	}
+
+	contexto_leitura ctx = {
+		.pedacos = (pedaco_entrada*) calloc(num_pedacos, sizeof(pedaco_entrada)),
+		.fatias = (fatia_nomes*) calloc(NUM_FATIAS_NOMES, sizeof(fatia_nomes)),
+		.nomes_vertices = NULL,
+		.arestas = NULL,
+		.erro = 0
+	};
+	ctx.erro = (!ctx.pedacos) || (!ctx.fatias);
+
+	if (!ctx.erro) {
+		for (unsigned int i = 0; i < NUM_FATIAS_NOMES; i++) {
+			pthread_mutex_init(&ctx.fatias[i].trava, NULL);
+		}
+
+		const char *inicio = p;
+		for (unsigned int i = 0; i < num_pedacos; i++) {
+			const char *corte = fim;
+			if (i + 1 < num_pedacos) {
+				corte = p + (size_t) (fim - p) / num_pedacos * (i + 1);
+				corte = (corte < inicio) ? inicio : corte;
+
+				const char *quebra = (const char*) memchr(corte, '\n', (size_t) (fim - corte));
+				corte = quebra ? quebra + 1 : fim;
+			}
+
+			ctx.pedacos[i].inicio = inicio;
+			ctx.pedacos[i].fim = corte;
+			inicio = corte;
+		}
+
+		executa_paralelo(num_pedacos, trabalhador_leitura, &ctx);
+	}
+
+	// Cada nome fica com o indice de sua primeira aparicao: os pedacos numeram, em ordem,
+	// os nomes que sao seus, a partir da quantidade de nomes dos pedacos anteriores
+	if (!ctx.erro) {
+		executa_paralelo(num_pedacos, trabalhador_proprios, &ctx);
+
+		unsigned int num_vertices = 0;
+		unsigned int num_arestas = 0;
+		for (unsigned int i = 0; i < num_pedacos; i++) {
+			ctx.pedacos[i].primeiro_indice = num_vertices;
+			ctx.pedacos[i].primeira_aresta = num_arestas;
+			num_vertices += ctx.pedacos[i].num_proprios;
+			num_arestas += ctx.pedacos[i].arestas.tamanho;
+		}
+
+		grafo_lido->vertices = (vertice*) malloc(sizeof(vertice) * (num_vertices ? num_vertices : 1));
+		grafo_lido->pendentes.arestas = ctx.arestas = (aresta*) malloc(sizeof(aresta) * (num_arestas ? num_arestas : 1));
+		ctx.nomes_vertices = (nome_local*) malloc(sizeof(nome_local) * (num_vertices ? num_vertices : 1));
+		ctx.erro = (!grafo_lido->vertices) || (!ctx.arestas) || (!ctx.nomes_vertices);
+
+		if (!ctx.erro) {
+			grafo_lido->capacidade_vertices = num_vertices ? num_vertices : 1;
+			grafo_lido->pendentes.capacidade = num_arestas ? num_arestas : 1;
+			grafo_lido->pendentes.tamanho = num_arestas;
+			grafo_lido->num_arestas = num_arestas;
+
+			executa_paralelo(num_pedacos, trabalhador_indices, &ctx);
+			executa_paralelo(num_pedacos, trabalhador_arestas, &ctx);
+
+			// Os nomes ainda apontam para a entrada; passam para a arena antes que ela seja liberada
+			for (unsigned int i = 0; (!ctx.erro) && (i < num_vertices); i++) {
+				vertice *vert = &grafo_lido->vertices[i];
+				vert->nome = copia_str(&grafo_lido->nomes, ctx.nomes_vertices[i].nome, ctx.nomes_vertices[i].tamanho);
+				vert->hash = ctx.nomes_vertices[i].hash;
+				ctx.erro = (vert->nome == NULL);
+				grafo_lido->num_vertices++;
+			}
+		}
+	}
+
+	libera_leitura(&ctx, num_pedacos);
+	if (tamanho_mapa) {
+		munmap(entrada - (tamanho_mapa - tamanho), tamanho_mapa);
+	} else {
+		free(entrada);
+	}
+
+	// Tabela hash do mesmo tamanho que le_grafo deixaria
+	if ((!ctx.erro) && (grafo_lido->num_vertices > 0)) {
+		unsigned int capacidade_hash = CAPACIDADE_HASH_INICIAL;
+		while (capacidade_hash < 2 * grafo_lido->num_vertices) {
+			capacidade_hash *= 2;
+		}
+
+		ctx.erro = !redimensiona_hash(grafo_lido, capacidade_hash);
+	}
+
+	if ((!ctx.erro) && (!constroi_adjacencia(grafo_lido))) {
+		ctx.erro = 1;
+	}
+
+	if (ctx.erro) {
+		printf("[le_grafo_paralelo] erro em malloc.\n");
+		destroi_grafo(grafo_lido);
+		return NULL;
+	}
+
+	ESTATISTICA(medicao_funcao.g = grafo_lido; termina_medicao(&medicao_funcao);)
+	return grafo_lido;
+}
+
+// desaloca toda a estrutura de dados alocada em g
+unsigned int destroi_grafo(grafo *g) {
+	unsigned int sucesso = 1;
+
+	// Num grafo carregado de imagem binaria, nomes, tabela hash e adjacencia ficam no mapa
+	// Se o mapa nao puder ser desfeito, o resto de g e liberado mesmo assim e so o erro e informado
+	if (g->mapa) {
+		sucesso = (munmap(g->mapa, g->tamanho_mapa) == 0);
+	} else {
+		free(g->tabela_hash);
+		free(g->inicio_adj);
+		free(g->vizinhos);
+		free(g->pesos);
+	}
+
+	// Os nomes ficam todos na arena, liberada em poucos blocos
+	libera_arena(&g->nomes);
+	free(g->vertices);
+	free(g->pendentes.arestas);
+	destroi_conjuntos(g->conjuntos);
+	destroi_blocos(g->blocos);
+	free(g->posto_nome);
+	free(g->ordem_nomes);
+	if (g->analise) {
+		limpa_analise(g->analise);
+		free(g->analise);
+	}
+	free(g);
+	return sucesso;
+}
+
+// grava g em caminho como imagem binaria
+unsigned int salva_grafo_binario(grafo *g, const char *caminho) {
+	MEDE_FUNCAO(g, ESTAT_SALVA_GRAFO_BINARIO);
+
+	if (!garante_adjacencia(g)) {
+		return 0;
 	}
 
-	dados_dfs_vertice dados = {
-		.tempo_descoberta = tempo_descoberta,
-		.low = low,
-		.pai = pai,
-		.eh_corte = eh_corte,
-		.tempo_atual = 0
+	FILE *arquivo = fopen(caminho, "wb");
+	if (!arquivo) {
+		return 0;
+	}
+
+	cabecalho_binario cab;
+	memset(&cab, 0, sizeof(cab));
+	memcpy(cab.magica, MAGICA_BINARIO, 8);
+	cab.versao = VERSAO_BINARIO;
+	cab.marca_endian = MARCA_ENDIAN;
+	cab.num_vertices = g->num_vertices;
+	cab.num_arestas = g->num_arestas;
+	cab.peso_minimo = g->peso_minimo;
+	cab.peso_maximo = g->peso_maximo;
+	cab.capacidade_hash = g->capacidade_hash;
+	cab.tem_nome = (g->nome != NULL);
+
+	// Offsets dos nomes na tabela de strings e hashes dos vertices
+	size_t n = g->num_vertices;
+	uint64_t *offsets_nomes = (uint64_t*) malloc(sizeof(uint64_t) * (n ? n : 1));
+	uint32_t *hashes = (uint32_t*) malloc(sizeof(uint32_t) * (n ? n : 1));
+	if ((!offsets_nomes) || (!hashes)) {
+		free(offsets_nomes);
+		free(hashes);
+		fclose(arquivo);
+		return 0;
+	}
+
+	uint64_t tamanho_nomes = 0;
+	for (size_t i = 0; i < n; i++) {
+		offsets_nomes[i] = tamanho_nomes;
+		hashes[i] = g->vertices[i].hash;
+		tamanho_nomes += strlen(g->vertices[i].nome) + 1;
+	}
+
+	// O cabecalho definitivo so e escrito no fim, quando o checksum e as secoes ja sao conhecidos
+	escritor_binario esc = {
+		.arquivo = arquivo,
+		.checksum = SEMENTE_CHECKSUM,
+		.posicao = sizeof(cab),
+		.num_pendentes = 0,
+		.erro = (fwrite(&cab, sizeof(cab), 1, arquivo) != 1)
 	};
 
-	for (unsigned int i = 0; i < g->num_vertices; i++) {
-		if (tempo_descoberta[i] == UINT_MAX) {
-			dfs_corte_vertices(g, i, &dados);
+	const char *nome_grafo = g->nome ? g->nome : "";
+	cab.secao_nome = esc.posicao;
+	escreve_bytes(&esc, nome_grafo, strlen(nome_grafo) + 1);
+	alinha_secao(&esc);
+
+	cab.secao_offsets_nomes = esc.posicao;
+	escreve_bytes(&esc, offsets_nomes, sizeof(uint64_t) * n);
+	alinha_secao(&esc);
+
+	cab.secao_nomes = esc.posicao;
+	for (size_t i = 0; i < n; i++) {
+		escreve_bytes(&esc, g->vertices[i].nome, strlen(g->vertices[i].nome) + 1);
+	}
+	alinha_secao(&esc);
+
+	cab.secao_hashes = esc.posicao;
+	escreve_bytes(&esc, hashes, sizeof(uint32_t) * n);
+	alinha_secao(&esc);
+
+	cab.secao_tabela_hash = esc.posicao;
+	escreve_bytes(&esc, g->tabela_hash, sizeof(uint32_t) * g->capacidade_hash);
+	alinha_secao(&esc);
+
+	size_t total_adj = 2 * (size_t) g->num_arestas;
+	cab.secao_inicio_adj = esc.posicao;
+	escreve_bytes(&esc, g->inicio_adj, sizeof(uint32_t) * (n + 1));
+	alinha_secao(&esc);
+
+	cab.secao_vizinhos = esc.posicao;
+	escreve_bytes(&esc, g->vizinhos, sizeof(uint32_t) * total_adj);
+	alinha_secao(&esc);
+
+	cab.secao_pesos = esc.posicao;
+	escreve_bytes(&esc, g->pesos, sizeof(uint32_t) * total_adj);
+	alinha_secao(&esc);
+
+	free(offsets_nomes);
+	free(hashes);
+
+	cab.tamanho_total = esc.posicao;
+	cab.checksum = checksum_imagem(&cab, esc.checksum);
+	unsigned int ok = (!esc.erro) && (fseek(arquivo, 0, SEEK_SET) == 0) && (fwrite(&cab, sizeof(cab), 1, arquivo) == 1);
+
+	if (fclose(arquivo) != 0) {
+		ok = 0;
+	}
+
+	return ok;
+}
+
+// carrega um grafo de uma imagem binaria gravada por salva_grafo_binario
+grafo *carrega_grafo_binario(const char *caminho) {
+	ESTATISTICA(medicao medicao_funcao = inicia_medicao(NULL, ESTAT_CARREGA_GRAFO_BINARIO);)
+	// A imagem guarda indices como inteiros de 32 bits que sao usados diretamente como unsigned int
+	if (sizeof(unsigned int) != sizeof(uint32_t)) {
+		return NULL;
+	}
+
+	FILE *arquivo = fopen(caminho, "rb");
+	if (!arquivo) {
+		return NULL;
+	}
+
+	struct stat info;
+	if ((fstat(fileno(arquivo), &info) != 0) || (info.st_size < (off_t) sizeof(cabecalho_binario))) {
+		fclose(arquivo);
+		return NULL;
+	}
+
+	size_t tamanho = (size_t) info.st_size;
+	void *mapa = mmap(NULL, tamanho, PROT_READ, MAP_PRIVATE, fileno(arquivo), 0);
+	fclose(arquivo);
+	if (mapa == MAP_FAILED) {
+		return NULL;
+	}
+
+	const unsigned char *base = (const unsigned char*) mapa;
+	const cabecalho_binario *cab = (const cabecalho_binario*) mapa;
+	uint64_t n = cab->num_vertices;
+	uint64_t total_adj = 2 * (uint64_t) cab->num_arestas;
+
+	// Confere cabecalho, limites das secoes, checksum e estrutura antes de usar qualquer dado
+	unsigned int valido = (memcmp(cab->magica, MAGICA_BINARIO, 8) == 0) &&
+		(cab->versao == VERSAO_BINARIO) && (cab->marca_endian == MARCA_ENDIAN) &&
+		(cab->tamanho_total == tamanho) && (tamanho % 8 == 0) &&
+		((cab->capacidade_hash & (cab->capacidade_hash - 1)) == 0) &&
+		((n == 0) || (2 * n <= cab->capacidade_hash)) &&
+		secao_valida(cab, cab->secao_nome, 1) &&
+		secao_valida(cab, cab->secao_offsets_nomes, 8 * n) &&
+		secao_valida(cab, cab->secao_nomes, 0) &&
+		secao_valida(cab, cab->secao_hashes, 4 * n) &&
+		secao_valida(cab, cab->secao_tabela_hash, 4 * (uint64_t) cab->capacidade_hash) &&
+		secao_valida(cab, cab->secao_inicio_adj, 4 * (n + 1)) &&
+		secao_valida(cab, cab->secao_vizinhos, 4 * total_adj) &&
+		secao_valida(cab, cab->secao_pesos, 4 * total_adj);
+
+	if (valido) {
+		uint64_t checksum = atualiza_checksum(SEMENTE_CHECKSUM, base + sizeof(cabecalho_binario), tamanho - sizeof(cabecalho_binario));
+		valido = (checksum_imagem(cab, checksum) == cab->checksum) && imagem_consistente(cab, base);
+	}
+
+	grafo *g = valido ? cria_grafo_vazio() : NULL;
+	vertice *vertices = g ? (vertice*) malloc(sizeof(vertice) * (n ? n : 1)) : NULL;
+	if (!vertices) {
+		free(g);
+		munmap(mapa, tamanho);
+		return NULL;
+	}
+
+	// Adjacencia e tabela hash sao usadas direto do mapa; so a lista de vertices e montada
+	const uint64_t *offsets_nomes = (const uint64_t*) (base + cab->secao_offsets_nomes);
+	const uint32_t *hashes = (const uint32_t*) (base + cab->secao_hashes);
+	char *nomes = (char*) mapa + cab->secao_nomes;
+
+	for (uint64_t i = 0; i < n; i++) {
+		vertices[i].nome = nomes + offsets_nomes[i];
+		vertices[i].hash = hashes[i];
+	}
+
+	g->mapa = mapa;
+	g->tamanho_mapa = tamanho;
+	g->nome = cab->tem_nome ? (char*) mapa + cab->secao_nome : NULL;
+	g->num_vertices = cab->num_vertices;
+	g->num_arestas = cab->num_arestas;
+	g->vertices = vertices;
+	g->capacidade_vertices = cab->num_vertices;
+	g->tabela_hash = (unsigned int*) ((char*) mapa + cab->secao_tabela_hash);
+	g->capacidade_hash = cab->capacidade_hash;
+	g->inicio_adj = (unsigned int*) ((char*) mapa + cab->secao_inicio_adj);
+	g->vizinhos = (unsigned int*) ((char*) mapa + cab->secao_vizinhos);
+	g->pesos = (unsigned int*) ((char*) mapa + cab->secao_pesos);
+	g->peso_minimo = cab->peso_minimo;
+	g->peso_maximo = cab->peso_maximo;
+	g->vertices_adj = cab->num_vertices;
+
+	ESTATISTICA(medicao_funcao.g = g; termina_medicao(&medicao_funcao);)
+	return g;
+}
+
+// cria um construtor de grafo com espaço para as quantidades estimadas de vértices e arestas
+grafo_builder *grafo_builder_cria(const char *nome_grafo, size_t num_vertices, size_t num_arestas) {
+	if ((num_vertices > MAXIMO_VERTICES_BUILDER) || (num_arestas >= UINT_MAX / 2)) {
+		return NULL;
+	}
+
+	grafo_builder *b = (grafo_builder*) malloc(sizeof(grafo_builder));
+	grafo *g = cria_grafo_vazio();
+	if ((!b) || (!g)) {
+		free(b);
+		free(g);
+		return NULL;
+	}
+
+	b->g = g;
+	b->estimativa_vertices = (unsigned int) num_vertices;
+	b->num_vertices = 0;
+
+	g->nome = nome_grafo ? copia_str(&g->nomes, nome_grafo, strlen(nome_grafo)) : NULL;
+	g->pendentes.arestas = (aresta*) malloc(sizeof(aresta) * (num_arestas ? num_arestas : 1));
+	g->pendentes.capacidade = num_arestas ? (unsigned int) num_arestas : 1;
+	if ((nome_grafo && !g->nome) || (!g->pendentes.arestas)) {
+		destroi_grafo(g);
+		free(b);
+		return NULL;
+	}
+
+	return b;
+}
+
+// acrescenta n arestas u[i] -- v[i] com peso w[i] (ou 1, se w é NULL) ao grafo de b
+unsigned int builder_adiciona_arestas(grafo_builder *b, const uint32_t *u, const uint32_t *v, const uint32_t *w, size_t n) {
+	lista_arestas *lista = &b->g->pendentes;
+
+	if (n > UINT_MAX / 2 - lista->tamanho) {
+		return 0;
+	}
+
+	// Identificadores sao os proprios indices dos vertices, limitados pela tabela hash
+	for (size_t i = 0; i < n; i++) {
+		if ((u[i] >= MAXIMO_VERTICES_BUILDER) || (v[i] >= MAXIMO_VERTICES_BUILDER)) {
+			return 0;
 		}
 	}
 
-	unsigned int contador = 0;
-	char **nomes_corte = malloc(g->num_vertices * sizeof(char*));
+	// Cresce no maximo uma vez por lote, e so se a estimativa de arestas foi curta
+	if (lista->tamanho + n > lista->capacidade) {
+		size_t nova_capacidade = 2 * (size_t) lista->capacidade;
+		if (nova_capacidade < lista->tamanho + n) {
+			nova_capacidade = lista->tamanho + n;
+		}
+		if (nova_capacidade > UINT_MAX / 2) {
+			nova_capacidade = UINT_MAX / 2;
+		}
 
-	for (unsigned int i = 0; i < g->num_vertices; i++) {
-		if (eh_corte[i]) {
-			nomes_corte[contador++] = g->vertices[i].nome;
+		aresta *realocacao_arestas = realloc(lista->arestas, sizeof(aresta) * nova_capacidade);
+		if (!realocacao_arestas) {
+			return 0;
 		}
- 	}
+		lista->arestas = realocacao_arestas;
+		lista->capacidade = (unsigned int) nova_capacidade;
+	}
+
+	unsigned int num_vertices = b->num_vertices;
+	for (size_t i = 0; i < n; i++) {
+		aresta *a = &lista->arestas[lista->tamanho + i];
+		a->u = u[i];
+		a->v = v[i];
+		a->peso = w ? w[i] : 1;
+
+		if (a->u >= num_vertices)
+			num_vertices = a->u + 1;
+		if (a->v >= num_vertices)
+			num_vertices = a->v + 1;
+	}
+
+	lista->tamanho += (unsigned int) n;
+	b->num_vertices = num_vertices;
+	return 1;
+}
+
+// garante que o grafo construído por b tenha ao menos os vértices 0 .. num_vertices-1
+unsigned int builder_define_num_vertices(grafo_builder *b, size_t num_vertices) {
+	if (num_vertices > MAXIMO_VERTICES_BUILDER) {
+		return 0;
+	}
+
+	if (num_vertices > b->num_vertices) {
+		b->num_vertices = (unsigned int) num_vertices;
+	}
+	return 1;
+}
+
+// termina a construção, desaloca b e devolve o grafo construído
+grafo *builder_finaliza(grafo_builder *b) {
+	ESTATISTICA(medicao medicao_funcao = inicia_medicao(NULL, ESTAT_BUILDER_FINALIZA);)
+	grafo *g = b->g;
+	unsigned int num_vertices = b->num_vertices;
+	unsigned int capacidade = (b->estimativa_vertices > num_vertices) ? b->estimativa_vertices : num_vertices;
+	free(b);
+
+	// Tabela hash e lista de vertices ja nascem do tamanho estimado (ou do final, se for maior),
+	// mas so os vertices usados sao criados
+	unsigned int capacidade_hash = CAPACIDADE_HASH_INICIAL;
+	while (capacidade_hash < 2 * capacidade) {
+		capacidade_hash *= 2;
+	}
+
+	g->vertices = (vertice*) malloc(sizeof(vertice) * (capacidade ? capacidade : 1));
+	if ((!g->vertices) || (!redimensiona_hash(g, capacidade_hash))) {
+		destroi_grafo(g);
+		return NULL;
+	}
+	g->capacidade_vertices = capacidade ? capacidade : 1;
+
+	// O vertice de identificador i tem indice i e se chama i, em decimal
+	for (unsigned int i = 0; i < num_vertices; i++) {
+		char buffer[16];
+		int tamanho = snprintf(buffer, sizeof(buffer), "%u", i);
+		busca_ou_cria_vertice(g, buffer, (size_t) tamanho);
+	}
+
+	g->num_arestas = g->pendentes.tamanho;
+	if (!constroi_adjacencia(g)) {
+		destroi_grafo(g);
+		return NULL;
+	}
+
+	ESTATISTICA(medicao_funcao.g = g; termina_medicao(&medicao_funcao);)
+	return g;
+}
+
+// insere em g o vértice v, se ainda não existe
+unsigned int insere_vertice(grafo *g, const char *v) {
+	MEDE_FUNCAO(g, ESTAT_INSERE_VERTICE);
+
+	if (!prepara_insercao(g)) {
+		return 0;
+	}
+
+	unsigned int num_vertices = g->num_vertices;
+	busca_ou_cria_vertice(g, v, strlen(v));
+	acompanha_vertices(g->conjuntos, g->num_vertices);
+	if (g->blocos) {
+		acompanha_blocos(g->blocos, g->num_vertices);
+	}
+
+	if (g->num_vertices != num_vertices) {
+		g->versao++;
+	}
+
+	return 1;
+}
+
+// insere em g a aresta u -- v com o peso dado, criando u e v se preciso
+unsigned int insere_aresta(grafo *g, const char *u, const char *v, unsigned int peso) {
+	MEDE_FUNCAO(g, ESTAT_INSERE_ARESTA);
+
+	if (!prepara_insercao(g)) {
+		return 0;
+	}
+
+	unsigned int indice_u = busca_ou_cria_vertice(g, u, strlen(u));
+	unsigned int indice_v = busca_ou_cria_vertice(g, v, strlen(v));
+	acompanha_vertices(g->conjuntos, g->num_vertices);
+
+	// A adjacencia so e refeita na proxima consulta que precisar dela
+	adiciona_aresta(&g->pendentes, indice_u, indice_v, peso);
+	g->num_arestas++;
+	if (g->blocos) {
+		acompanha_blocos(g->blocos, g->num_vertices);
+		insere_aresta_blocos(g, indice_u, indice_v);
+	}
+	une_conjuntos(g->conjuntos, indice_u, indice_v);
+	g->versao++;
+
+	return 1;
+}
+
+// define quantas threads as funções de g podem usar
+void define_num_threads(grafo *g, unsigned int num_threads) {
+	g->num_threads = num_threads;
+}
+
+// define a estratégia usada por diametros
+void define_modo_diametro(grafo *g, modo_diametro modo) {
+	g->modo_diametro = modo;
+}
+
+// renumera os vértices de g na ordem pedida, para melhorar a localidade das buscas
+unsigned int reordena_vertices(grafo *g, ordem_vertices ordem) {
+	MEDE_FUNCAO(g, ESTAT_REORDENA_VERTICES);
+
+	if ((!materializa_grafo(g)) || (!garante_adjacencia(g))) {
+		return 0;
+	}
+
+	unsigned int *nova_ordem = (unsigned int*) malloc(sizeof(unsigned int) * (g->num_vertices ? g->num_vertices : 1));
+	if (!nova_ordem) {
+		return 0;
+	}
+
+	unsigned int sucesso = 0;
+	switch (ordem) {
+		case ORDEM_CUTHILL_MCKEE:
+			sucesso = ordem_cuthill_mckee(g, nova_ordem);
+			break;
+		case ORDEM_LARGURA:
+			sucesso = ordem_largura(g, nova_ordem);
+			break;
+		case ORDEM_GRAU:
+			sucesso = ordem_grau(g, nova_ordem);
+			break;
+	}
+
+	sucesso = sucesso && aplica_ordem(g, nova_ordem);
+	free(nova_ordem);
+	return sucesso;
+}
+
+// preenche m com o uso de memória de g
+void uso_de_memoria(grafo *g, memoria_grafo *m) {
+	size_t total_adj = g->inicio_adj ? g->inicio_adj[g->vertices_adj] : 0;
+
+	m->blocos_arena = g->nomes.num_blocos;
+	m->bytes_arena = g->nomes.bytes_reservados;
+	m->bytes_nomes = g->nomes.bytes_usados;
+	m->num_nomes = g->nomes.num_alocacoes;
+	m->bytes_estruturas = sizeof(vertice) * g->capacidade_vertices;
+	if (!g->mapa) {
+		m->bytes_estruturas += sizeof(unsigned int) * (g->capacidade_hash + (size_t) g->vertices_adj + 1 + 2 * total_adj);
+	}
+	m->bytes_estruturas += sizeof(aresta) * g->pendentes.capacidade;
+	m->bytes_estruturas += sizeof(unsigned int) * 2 * (size_t) (g->posto_nome ? g->vertices_postos : 0);
+	m->bytes_mapa = g->tamanho_mapa;
+}
+
+// preenche e com as estatísticas de g
+unsigned int grafo_estatisticas(grafo *g, estatisticas_grafo *e) {
+#ifdef GRAFO_STATS
+	*e = g->estatisticas;
+	return 1;
+#else
+	(void) g;
+	memset(e, 0, sizeof(estatisticas_grafo));
+	return 0;
+#endif
+}
+
+// devolve o nome de g
+char *nome(grafo *g) {
+	return g->nome;
+}
+
+// devolve 1 se g é bipartido e 0 caso contrário
+unsigned int bipartido(grafo *g) {
+	MEDE_FUNCAO(g, ESTAT_BIPARTIDO);
+
+	// Depois de alguma insercao, os conjuntos disjuntos respondem direto
+	if (g->conjuntos) {
+		return g->conjuntos->bipartido;
+	}
+
+	grafo_analise *a = analise_bipartido(g);
+
+	return a ? a->bipartido : 0;
+}
+
+// devolve o número de vértices em g
+unsigned int n_vertices(grafo *g) {
+	return g->num_vertices;
+}
+
+// devolve o número de arestas em g
+unsigned int n_arestas(grafo *g) {
+	return g->num_arestas;
+}
 
-	qsort(nomes_corte, contador, sizeof(char*), compara_nome_vertices);
+// devolve o número de componentes em g
+unsigned int n_componentes(grafo *g) {
+	MEDE_FUNCAO(g, ESTAT_N_COMPONENTES);
+
+	if (g->conjuntos) {
+		return g->conjuntos->num_conjuntos;
+	}
+
+	grafo_analise *a = analise_componentes(g);
+
+	return a ? a->num_componentes : 0;
+}
+
+// devolve uma "string" com os diâmetros dos componentes de g separados por brancos
+// em ordem não decrescente
+char *diametros(grafo *g) {
+	MEDE_FUNCAO(g, ESTAT_DIAMETROS);
+
+	grafo_analise *a = analise_diametros(g);
+	if (!a) {
+		return NULL;
+	}
 
-	size_t tamanho_total = 0;
-	for (unsigned int i = 0; i < contador; i++) {
-		tamanho_total += strlen(nomes_corte[i]) + 1; 
+	// Mede a resposta antes, para uma unica alocacao
+	char buffer[24];
+	size_t tamanho_total = 1;
+	for (unsigned int i = 0; i < a->num_componentes; i++) {
+		tamanho_total += (size_t) snprintf(buffer, sizeof(buffer), "%" PRIu64, a->diametros[i]) + 1;
 	}
 
-	// Construir string de resultado
-	char *resultado = malloc(tamanho_total > 0 ? tamanho_total : 1);
+	char *resultado = malloc(tamanho_total);
 	if (!resultado) {
-		free(nomes_corte);
-		free(tempo_descoberta);
-		free(low);
-		free(pai);
-		free(eh_corte);
 		return NULL;
 	}
 
 	char *ptr = resultado;
-	for (unsigned int i = 0; i < contador; i++) {
-		size_t len = strlen(nomes_corte[i]);
+	for (unsigned int i = 0; i < a->num_componentes; i++) {
 		if (i > 0) {
 			*ptr++ = ' ';
 		}
-		memcpy(ptr, nomes_corte[i], len);
-		ptr += len;
+		ptr += snprintf(ptr, sizeof(buffer), "%" PRIu64, a->diametros[i]);
 	}
 	*ptr = '\0';
 
-	// Liberar memória auxiliar
-	free(nomes_corte);
-	free(tempo_descoberta);
-	free(low);
-	free(pai);
-	free(eh_corte);
- 
 	return resultado;
 }
 
+// devolve uma "string" com os nomes dos vértices de corte de g em
+// ordem alfabética, separados por brancos
+char *vertices_corte(grafo *g) {
+	MEDE_FUNCAO(g, ESTAT_VERTICES_CORTE);
+
+	if (g->num_vertices == 0) {
+		return string_vazia();
+	}
+
+	grafo_analise *a = analise_cortes(g);
+	if (!a) {
+		return NULL;
+	}
+
+	cortes *c = a->dados_cortes;
+	return junta_nomes(g, c->vertices_ordenados, c->num_vertices_corte);
+}
+
 // devolve uma "string" com as arestas de corte de g em ordem alfabética, separadas por brancos
 // cada aresta é o par de nomes de seus vértices em ordem alfabética, separadas por brancos
 //
 // por exemplo, se as arestas de corte são {z, a}, {x, b} e {y, c}, a resposta será a string
 // "a z b x c y"
 char *arestas_corte(grafo *g) {
+	MEDE_FUNCAO(g, ESTAT_ARESTAS_CORTE);
+
 	if (g->num_vertices == 0 || g->num_arestas == 0) {
-		char *resposta = malloc(1);
-		if (resposta) {
-			resposta[0] = '\0';
-		}
+		return string_vazia();
+	}
 
-		return resposta;
+	grafo_analise *a = analise_cortes(g);
+	if (!a) {
+		return NULL;
 	}
 
-	// Aloca estruturas para DFS
-	unsigned int *tempo_descoberta = malloc(g->num_vertices * sizeof(unsigned int));
-	unsigned int *low = malloc(g->num_vertices * sizeof(unsigned int));
-	int *pai = malloc(g->num_vertices * sizeof(int));
+	// As pontes ja estao em ordem, cada uma com as pontas em ordem alfabetica
+	cortes *c = a->dados_cortes;
+	return junta_nomes(g, c->pontes, 2 * c->num_pontes);
+}
 
-	if (!tempo_descoberta || !low || !pai) {
-		free(tempo_descoberta);
-		free(low);
-		free(pai);
-		return NULL;
+// devolve o nome do vértice de identificador id em g (ou NULL se não existe)
+const char *nome_vertice(grafo *g, unsigned int id) {
+	return id < g->num_vertices ? g->vertices[id].nome : NULL;
+}
+
+// preenche destino com até capacidade diâmetros de g, em ordem não decrescente,
+// e *total com o número de componentes
+unsigned int diametros_em(grafo *g, uint64_t *destino, unsigned int capacidade, unsigned int *total) {
+	MEDE_FUNCAO(g, ESTAT_DIAMETROS_EM);
+
+	grafo_analise *a = analise_diametros(g);
+	if (!a) {
+		return 0;
 	}
 
-	// Inicializa estruturas DFS
-	for (unsigned int i = 0; i < g->num_vertices; i++) {
-		tempo_descoberta[i] = UINT_MAX;
-		low[i] = UINT_MAX;
-		pai[i] = -1;
+	unsigned int quantidade = a->num_componentes < capacidade ? a->num_componentes : capacidade;
+	if (quantidade > 0) {
+		memcpy(destino, a->diametros, sizeof(uint64_t) * quantidade);
 	}
 
-	// Aloca array para armazenar arestas de corte
-	aresta_corte *arestas = malloc(g->num_arestas * sizeof(aresta_corte));
-	unsigned int contador = 0;
+	*total = a->num_componentes;
+	return 1;
+}
 
-	dados_dfs_aresta dados = {
-		.tempo_descoberta = tempo_descoberta,
-		.low = low,
-		.pai = pai,
-		.tempo_atual = 0
-	};
+// preenche destino com até capacidade identificadores dos vértices de corte de g, na
+// ordem alfabética dos nomes, e *total com o número de vértices de corte
+unsigned int vertices_corte_em(grafo *g, unsigned int *destino, unsigned int capacidade, unsigned int *total) {
+	MEDE_FUNCAO(g, ESTAT_VERTICES_CORTE_EM);
 
-	// Executa DFS para cada componente
-	for (unsigned int i = 0; i < g->num_vertices; i++) {
-		if (tempo_descoberta[i] == UINT_MAX) {
-			dfs_corte_arestas(g, i, &dados, arestas, &contador);
-		}
+	*total = 0;
+	if (g->num_vertices == 0) {
+		return 1;
 	}
 
-	// Ordena arestas alfabeticamente
-	qsort(arestas, contador, sizeof(aresta_corte), compara_nome_arestas);
+	grafo_analise *a = analise_cortes(g);
+	if (!a) {
+		return 0;
+	}
 
-	// Calcula tamanho total da string resultado
-	size_t tamanho_total = 0;
-	for (unsigned int i = 0; i < contador; i++) {
-		tamanho_total += strlen(arestas[i].u) + 1;
-		tamanho_total += strlen(arestas[i].v) + 1;
+	cortes *c = a->dados_cortes;
+	unsigned int quantidade = c->num_vertices_corte < capacidade ? c->num_vertices_corte : capacidade;
+	if (quantidade > 0) {
+		memcpy(destino, c->vertices_ordenados, sizeof(unsigned int) * quantidade);
 	}
 
-	// Aloca e constrói string resultado
-	char *resultado = malloc(tamanho_total > 0 ? tamanho_total : 1);
-	if (!resultado) {
-		// Libera memória alocada para nomes
-		for (unsigned int i = 0; i < contador; i++) {
-			free(arestas[i].u);
-			free(arestas[i].v);
-		}
+	*total = c->num_vertices_corte;
+	return 1;
+}
 
-		free(arestas);
-		free(tempo_descoberta);
-		free(low);
-		free(pai);
-		return NULL;
+// preenche destino com até capacidade arestas de corte de g, como pares de identificadores
+// (2 * capacidade posições), na ordem de arestas_corte, e *total com o número de arestas de corte
+unsigned int arestas_corte_em(grafo *g, unsigned int *destino, unsigned int capacidade, unsigned int *total) {
+	MEDE_FUNCAO(g, ESTAT_ARESTAS_CORTE_EM);
+
+	*total = 0;
+	if (g->num_vertices == 0 || g->num_arestas == 0) {
+		return 1;
 	}
 
-	char *ptr = resultado;
-	for (unsigned int i = 0; i < contador; i++) {
-		// Copia primeiro nome
-		size_t len_u = strlen(arestas[i].u);
-		memcpy(ptr, arestas[i].u, len_u);
-		ptr += len_u;
-		*ptr++ = ' ';
-
-		// Copia segundo nome
-		size_t len_v = strlen(arestas[i].v);
-		memcpy(ptr, arestas[i].v, len_v);
-		ptr += len_v;
-
-		// Adiciona espaço entre pares
-		if (i < contador - 1) {
-			*ptr++ = ' ';
-		}
+	grafo_analise *a = analise_cortes(g);
+	if (!a) {
+		return 0;
+	}
 
-		// Libera nomes individuais
-		free(arestas[i].u);
-		free(arestas[i].v);
+	cortes *c = a->dados_cortes;
+	unsigned int quantidade = c->num_pontes < capacidade ? c->num_pontes : capacidade;
+	if (quantidade > 0) {
+		memcpy(destino, c->pontes, 2 * sizeof(unsigned int) * quantidade);
 	}
-	*ptr = '\0';
 
-	// Libera memória auxiliar
-	free(arestas);
-	free(tempo_descoberta);
-	free(low);
-	free(pai);
-	
-	return resultado;
-}
\ No newline at end of file
+	*total = c->num_pontes;
+	return 1;
+}
+
+// devolve 1 se u -- v é aresta de corte de g e 0 caso contrário
+unsigned int eh_ponte(grafo *g, const char *u, const char *v) {
+	MEDE_FUNCAO(g, ESTAT_EH_PONTE);
+
+	unsigned int indice_u = indice_do_vertice(g, u);
+	unsigned int indice_v = indice_do_vertice(g, v);
+	if ((indice_u == UINT_MAX) || (indice_v == UINT_MAX) || (indice_u == indice_v)) {
+		return 0;
+	}
+
+	// Com os blocos incrementais, a aresta da floresta e ponte se esta sozinha no seu bloco
+	if (g->blocos) {
+		blocos_incrementais *b = g->blocos;
+		unsigned int filho = (b->pai[indice_v] == indice_u) ? indice_v : indice_u;
+		unsigned int outro = (filho == indice_v) ? indice_u : indice_v;
+
+		return (b->pai[filho] == outro) && (b->tamanho_bloco[busca_bloco(b, b->aresta[filho])] == 1);
+	}
+
+	grafo_analise *a = analise_indice_cortes(g);
+	if (!a) {
+		return 0;
+	}
+
+	// Toda ponte e aresta da arvore da busca e separa componentes sem pontes diferentes
+	cortes *c = a->dados_cortes;
+	return ((c->pai[indice_u] == indice_v) || (c->pai[indice_v] == indice_u)) &&
+	       (c->componente_sem_pontes[indice_u] != c->componente_sem_pontes[indice_v]);
+}
+
+// devolve 1 se v é vértice de corte de g e 0 caso contrário
+unsigned int eh_vertice_corte(grafo *g, const char *v) {
+	MEDE_FUNCAO(g, ESTAT_EH_VERTICE_CORTE);
+
+	unsigned int indice = indice_do_vertice(g, v);
+	if (indice == UINT_MAX) {
+		return 0;
+	}
+
+	if (g->blocos) {
+		return g->blocos->num_topos[indice] >= ((g->blocos->pai[indice] != UINT_MAX) ? 1u : 2u);
+	}
+
+	grafo_analise *a = analise_cortes(g);
+	return a ? a->dados_cortes->eh_corte[indice] : 0;
+}
+
+// devolve o nó de v na árvore de blocos e vértices de corte de g
+unsigned int bloco_de(grafo *g, const char *v) {
+	MEDE_FUNCAO(g, ESTAT_BLOCO_DE);
+
+	unsigned int indice = indice_do_vertice(g, v);
+	if (indice == UINT_MAX) {
+		return UINT_MAX;
+	}
+
+	grafo_analise *a = analise_indice_cortes(g);
+	return a ? a->dados_cortes->no_arvore[indice] : UINT_MAX;
+}
@@ -2,6 +2,7 @@
 #define GRAFO_H
 
 #include <stdio.h>
+#include <stdint.h>
 
 //------------------------------------------------------------------------------
 // estrutura de dados para representar um grafo
@@ -15,6 +16,9 @@ typedef struct grafo grafo;
 //
 // o nome do grafo, cada vértice e cada aresta aparecem numa linha por si só
 // cada linha tem no máximo 2047 caracteres
+//
+// se f é um arquivo comum, ele é mapeado em memória; caso contrário (pipes, terminais)
+// é lido em blocos grandes
 // linhas iniciando por // são consideradas comentários e são ignoradas
 //
 // um vértice é representado por uma "string"
@@ -47,12 +51,245 @@ três
 */
 grafo *le_grafo(FILE *f);
 
+//------------------------------------------------------------------------------
+// lê um grafo de f como le_grafo, usando num_threads threads, e o devolve
+//
+// a entrada é dividida em pedaços terminados em fim de linha, lidos em paralelo;
+// os vértices ficam numerados na mesma ordem de le_grafo (a da primeira aparição
+// de cada nome), então os resultados são os mesmos
+//
+// 0 usa o número de processadores disponíveis; o grafo devolvido usa num_threads
+// threads também nas demais funções (veja define_num_threads)
+grafo *le_grafo_paralelo(FILE *f, unsigned int num_threads);
+
 //------------------------------------------------------------------------------
 // desaloca toda a estrutura de dados alocada em g
 //
 // devolve 1 em caso de sucesso e 0 em caso de erro
 unsigned int destroi_grafo(grafo *g);
 
+//------------------------------------------------------------------------------
+// grava g no arquivo caminho como uma imagem binária
+//
+// a imagem tem um cabeçalho com versão e checksum, a tabela de nomes dos vértices e
+// os vetores de adjacência, e pode ser carregada muito mais rápido do que o texto
+//
+// devolve 1 em caso de sucesso e 0 em caso de erro
+unsigned int salva_grafo_binario(grafo *g, const char *caminho);
+
+//------------------------------------------------------------------------------
+// carrega um grafo gravado por salva_grafo_binario e o devolve
+//
+// o arquivo é mapeado em memória e usado praticamente como está
+// devolve NULL se o arquivo não existe, é de outra versão ou está corrompido
+grafo *carrega_grafo_binario(const char *caminho);
+
+//------------------------------------------------------------------------------
+// construção de um grafo direto da memória, sem passar por texto
+//
+// os vértices são identificados por inteiros: o grafo construído tem os vértices
+// 0 .. n-1, onde n é 1 + o maior identificador usado numa aresta (ou mais, com
+// builder_define_num_vertices), e o nome de cada vértice é seu identificador em decimal
+// os identificadores devem ser menores que 2^30
+//
+// as estimativas num_vertices e num_arestas de grafo_builder_cria só dimensionam as
+// estruturas de uma vez, sem mudar o grafo; se forem corretas, a construção não faz
+// nenhuma realocação
+typedef struct grafo_builder grafo_builder;
+
+//------------------------------------------------------------------------------
+// cria um construtor para um grafo de nome nome_grafo (ou sem nome, se NULL)
+//
+// devolve NULL em caso de erro
+grafo_builder *grafo_builder_cria(const char *nome_grafo, size_t num_vertices, size_t num_arestas);
+
+//------------------------------------------------------------------------------
+// acrescenta as n arestas u[i] -- v[i] com peso w[i] ao grafo em construção
+// se w é NULL, todas as arestas têm peso 1
+//
+// devolve 1 em caso de sucesso e 0 em caso de erro (nesse caso nenhuma aresta do lote é acrescentada)
+unsigned int builder_adiciona_arestas(grafo_builder *b, const uint32_t *u, const uint32_t *v, const uint32_t *w, size_t n);
+
+//------------------------------------------------------------------------------
+// garante que o grafo em construção tenha ao menos os vértices 0 .. num_vertices-1,
+// inclusive os que não aparecem em nenhuma aresta
+//
+// devolve 1 em caso de sucesso e 0 em caso de erro (num_vertices maior que 2^30)
+unsigned int builder_define_num_vertices(grafo_builder *b, size_t num_vertices);
+
+//------------------------------------------------------------------------------
+// termina a construção, desaloca b e devolve o grafo
+//
+// as arestas são agrupadas por vértice numa única passada; os vizinhos de cada
+// vértice ficam na ordem em que as arestas foram acrescentadas
+// devolve NULL em caso de erro
+grafo *builder_finaliza(grafo_builder *b);
+
+//------------------------------------------------------------------------------
+// insere em g o vértice v, se ainda não existe
+//
+// se g veio de carrega_grafo_binario, a primeira inserção copia o grafo para a
+// memória e desfaz o mapeamento do arquivo: os ponteiros devolvidos antes por nome
+// e nome_vertice deixam de valer
+//
+// devolve 1 em caso de sucesso e 0 em caso de erro
+unsigned int insere_vertice(grafo *g, const char *v);
+
+//------------------------------------------------------------------------------
+// insere em g a aresta u -- v com o peso dado, criando u e v se ainda não existem
+//
+// a partir da primeira inserção, n_componentes e bipartido respondem em O(1); depois
+// da primeira consulta de cortes, eh_ponte e eh_vertice_corte também respondem em O(1),
+// mas vertices_corte, arestas_corte, suas versões _em e bloco_de custam O(V) na
+// primeira chamada depois de cada inserção; as demais funções refazem seus cálculos
+//
+// como em insere_vertice, a primeira inserção num grafo de carrega_grafo_binario
+// invalida os ponteiros devolvidos antes por nome e nome_vertice
+//
+// devolve 1 em caso de sucesso e 0 em caso de erro
+unsigned int insere_aresta(grafo *g, const char *u, const char *v, unsigned int peso);
+
+//------------------------------------------------------------------------------
+// define quantas threads as funções de g podem usar
+//
+// 0 usa o número de processadores disponíveis
+// o padrão é 1, ou seja, execução sequencial
+//
+// com mais de uma thread, as componentes, os vértices de corte e as arestas de corte de
+// grafos grandes são calculados em paralelo; no cálculo dos diâmetros, as componentes
+// pequenas são repartidas entre as threads e, em cada componente grande, cada rodada
+// dos limitantes faz uma busca por thread; as respostas não dependem do número de threads
+//
+// as threads auxiliares são criadas na primeira vez em que são necessárias e
+// reaproveitadas pelas chamadas seguintes, de qualquer grafo
+void define_num_threads(grafo *g, unsigned int num_threads);
+
+//------------------------------------------------------------------------------
+// estratégias para o cálculo dos diâmetros
+//
+// DIAMETRO_LIMITANTES (padrão): limitantes de excentricidade (Takes e Kosters), que
+// costumam resolver cada componente com poucas buscas a partir de vértices escolhidos;
+// quando todos os pesos são 1 e os limitantes passam a descartar poucos vértices por
+// busca, os vértices que restam numa componente grande passam todos pelas buscas em
+// largura com várias origens descritas abaixo
+//
+// DIAMETRO_EXAUSTIVO: uma busca a partir de cada vértice; serve para conferir o resultado
+// quando todos os pesos são 1, as buscas em largura saem de 64 a 256 vértices próximos de
+// uma vez (conforme as instruções vetoriais disponíveis), com um bit por origem em cada vértice
+typedef enum {
+  DIAMETRO_LIMITANTES,
+  DIAMETRO_EXAUSTIVO
+} modo_diametro;
+
+//------------------------------------------------------------------------------
+// define a estratégia usada por diametros em g
+void define_modo_diametro(grafo *g, modo_diametro modo);
+
+//------------------------------------------------------------------------------
+// ordens para a renumeração dos vértices por reordena_vertices
+//
+// ORDEM_CUTHILL_MCKEE: Cuthill–McKee reversa, uma busca em largura a partir do vértice
+// de menor grau de cada componente, com os vizinhos em ordem crescente de grau, invertida;
+// aproxima vértices vizinhos e costuma ser a melhor para grafos esparsos e "alongados"
+//
+// ORDEM_LARGURA: a ordem da busca em largura por níveis das componentes, feita sempre
+// com uma thread, para que a numeração não dependa de define_num_threads
+//
+// ORDEM_GRAU: grau decrescente, com os vértices de maior grau juntos no começo; serve
+// para grafos com poucos vértices de grau muito alto
+typedef enum {
+  ORDEM_CUTHILL_MCKEE,
+  ORDEM_LARGURA,
+  ORDEM_GRAU
+} ordem_vertices;
+
+//------------------------------------------------------------------------------
+// renumera os vértices de g na ordem dada, permutando a adjacência para que as buscas
+// percorram a memória com menos saltos (os vértices numerados na ordem de aparição na
+// entrada costumam ficar espalhados)
+//
+// todas as respostas continuam dadas pelos nomes e não mudam; mudam só os
+// identificadores inteiros de nome_vertice e das funções *_em e a numeração de
+// bloco_de. Os resultados guardados são descartados
+//
+// se g veio de carrega_grafo_binario, o grafo é antes copiado para a memória e o
+// mapeamento do arquivo é desfeito: os ponteiros devolvidos antes por nome e
+// nome_vertice deixam de valer
+//
+// devolve 1 em caso de sucesso e 0 em caso de erro
+unsigned int reordena_vertices(grafo *g, ordem_vertices ordem);
+
+//------------------------------------------------------------------------------
+// uso de memória de um grafo
+//
+// os nomes (do grafo e dos vértices) ficam numa arena de poucos blocos grandes:
+// blocos_arena e bytes_arena são os blocos alocados e seu tamanho total, e
+// num_nomes e bytes_nomes são quantos nomes estão guardados neles e quanto ocupam
+//
+// bytes_estruturas soma a lista de vértices, a tabela de nomes e a adjacência;
+// bytes_mapa é o tamanho da imagem binária mapeada (0 se o grafo não veio de uma)
+typedef struct {
+  size_t blocos_arena;
+  size_t bytes_arena;
+  size_t num_nomes;
+  size_t bytes_nomes;
+  size_t bytes_estruturas;
+  size_t bytes_mapa;
+} memoria_grafo;
+
+//------------------------------------------------------------------------------
+// preenche m com o uso de memória de g
+void uso_de_memoria(grafo *g, memoria_grafo *m);
+
+//------------------------------------------------------------------------------
+// funções da biblioteca medidas quando ela é compilada com -DGRAFO_STATS
+typedef enum {
+  ESTAT_LE_GRAFO,
+  ESTAT_LE_GRAFO_PARALELO,
+  ESTAT_CARREGA_GRAFO_BINARIO,
+  ESTAT_SALVA_GRAFO_BINARIO,
+  ESTAT_BUILDER_FINALIZA,
+  ESTAT_INSERE_VERTICE,
+  ESTAT_INSERE_ARESTA,
+  ESTAT_N_COMPONENTES,
+  ESTAT_BIPARTIDO,
+  ESTAT_DIAMETROS,
+  ESTAT_VERTICES_CORTE,
+  ESTAT_ARESTAS_CORTE,
+  ESTAT_DIAMETROS_EM,
+  ESTAT_VERTICES_CORTE_EM,
+  ESTAT_ARESTAS_CORTE_EM,
+  ESTAT_REORDENA_VERTICES,
+  ESTAT_EH_PONTE,
+  ESTAT_EH_VERTICE_CORTE,
+  ESTAT_BLOCO_DE,
+  NUM_ESTAT_FUNCOES
+} funcao_estatistica;
+
+//------------------------------------------------------------------------------
+// estatísticas acumuladas por um grafo desde sua criação
+//
+// segundos[f] e chamadas[f] são o tempo total e o número de chamadas da função f;
+// os contadores somam o trabalho de todas as threads: vértices visitados e
+// arestas examinadas nas buscas, execuções de caminhos mínimos a partir de uma
+// origem, inserções e remoções em heap e baldes, e bytes alocados
+typedef struct {
+  double segundos[NUM_ESTAT_FUNCOES];
+  uint64_t chamadas[NUM_ESTAT_FUNCOES];
+  uint64_t vertices_visitados;
+  uint64_t arestas_examinadas;
+  uint64_t execucoes_sssp;
+  uint64_t operacoes_fila;
+  uint64_t bytes_alocados;
+} estatisticas_grafo;
+
+//------------------------------------------------------------------------------
+// preenche e com as estatísticas de g
+//
+// devolve 1 se a biblioteca foi compilada com -DGRAFO_STATS, ou
+// zera e e devolve 0 caso contrário
+unsigned int grafo_estatisticas(grafo *g, estatisticas_grafo *e);
+
 //------------------------------------------------------------------------------
 // devolve o nome de g
 char *nome(grafo *g);
@@ -91,4 +328,64 @@ char *vertices_corte(grafo *g);
 // "a z b x c y"
 char *arestas_corte(grafo *g);
 
+//------------------------------------------------------------------------------
+// consultas estruturadas, que não alocam memória a cada chamada
+//
+// os vértices são identificados por inteiros 0 .. n_vertices(g)-1, na ordem em que
+// aparecem pela primeira vez (na entrada ou em insere_vertice/insere_aresta); num
+// grafo de grafo_builder, o identificador é o próprio id do vértice
+//
+// cada função escreve em destino no máximo capacidade resultados, na mesma ordem da
+// versão que devolve "string", e guarda em *total quantos resultados existem; com
+// capacidade 0 (e destino NULL) ela só informa o tamanho necessário
+//
+// devolvem 1 em caso de sucesso e 0 em caso de erro
+
+//------------------------------------------------------------------------------
+// devolve o nome do vértice de identificador id em g, ou NULL se não existe
+const char *nome_vertice(grafo *g, unsigned int id);
+
+//------------------------------------------------------------------------------
+// diâmetros dos componentes de g, em ordem não decrescente
+unsigned int diametros_em(grafo *g, uint64_t *destino, unsigned int capacidade, unsigned int *total);
+
+//------------------------------------------------------------------------------
+// identificadores dos vértices de corte de g, na ordem alfabética dos nomes
+unsigned int vertices_corte_em(grafo *g, unsigned int *destino, unsigned int capacidade, unsigned int *total);
+
+//------------------------------------------------------------------------------
+// arestas de corte de g, na ordem de arestas_corte; cada aresta ocupa duas posições
+// de destino (que precisa de 2 * capacidade posições), com as pontas em ordem alfabética
+unsigned int arestas_corte_em(grafo *g, unsigned int *destino, unsigned int capacidade, unsigned int *total);
+
+//------------------------------------------------------------------------------
+// consultas pontuais sobre os cortes de g, pelos nomes dos vértices
+//
+// a primeira consulta depois de uma mudança no grafo calcula, numa única passada
+// linear sobre os cortes, um índice com a árvore de blocos e vértices de corte e
+// as componentes que sobram sem as pontes; as seguintes respondem em tempo
+// constante, sem montar nem percorrer as strings de vertices_corte e arestas_corte
+// (com os blocos mantidos por insere_aresta, eh_ponte e eh_vertice_corte nem
+// precisam do índice)
+
+//------------------------------------------------------------------------------
+// devolve 1 se u -- v é aresta de corte de g e 0 caso contrário (inclusive se u, v
+// ou a aresta não existem)
+unsigned int eh_ponte(grafo *g, const char *u, const char *v);
+
+//------------------------------------------------------------------------------
+// devolve 1 se v é vértice de corte de g e 0 caso contrário (inclusive se v não existe)
+unsigned int eh_vertice_corte(grafo *g, const char *v);
+
+//------------------------------------------------------------------------------
+// devolve o nó de v na árvore de blocos e vértices de corte de g, ou UINT_MAX se v
+// não existe ou em caso de erro
+//
+// os blocos (componentes biconexas, com cada vértice isolado formando um bloco
+// sozinho) são os nós 0 .. b-1, em ordem pelos dois menores identificadores de
+// vértice de cada um, e os vértices de corte são os nós seguintes, na ordem de
+// vertices_corte; um vértice que não é de corte está num único bloco, e dois
+// vértices que não são de corte estão no mesmo bloco se e só se bloco_de é igual
+unsigned int bloco_de(grafo *g, const char *v);
+
 #endif
@@ -0,0 +1,764 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <unistd.h>
+#include "grafo.h"
+
+//------------------------------------------------------------------------------
+// uso: ./verifica [num_grafos]
+//
+// gera num_grafos multigrafos aleatórios (com laços, arestas repetidas, vértices
+// isolados e pesos 1, pequenos ou perto de 2^32), quase todos pequenos, e confere que cada forma de
+// construir, transformar ou consultar um grafo dá as mesmas respostas que
+// le_grafo seguido das consultas de teste.c
+//
+// imprime as primeiras diferenças encontradas, com a semente do grafo, e sai
+// com 1 se houve alguma
+
+#define MAXIMO_FALHAS_IMPRESSAS 10
+#define MAXIMO_VERTICES_FORCA_BRUTA 120
+#define MAXIMO_VERTICES_EXAUSTIVO 2000
+#define MAXIMO_BYTES_CORROMPIDOS 1024
+
+//------------------------------------------------------------------------------
+// multigrafo gerado, com vértices 0 .. num_vertices-1 chamados pelo número em decimal
+typedef struct {
+  uint32_t num_vertices;
+  uint32_t num_arestas;
+  uint32_t *u;
+  uint32_t *v;
+  uint32_t *w;
+  unsigned int unitario;
+} grafo_gerado;
+
+//------------------------------------------------------------------------------
+// gerador xorshift64*, para que os grafos sejam os mesmos a cada execução
+static uint64_t estado_aleatorio;
+
+static uint32_t aleatorio(uint32_t limite) {
+
+  estado_aleatorio ^= estado_aleatorio >> 12;
+  estado_aleatorio ^= estado_aleatorio << 25;
+  estado_aleatorio ^= estado_aleatorio >> 27;
+
+  return (uint32_t) ((estado_aleatorio * 2685821657736338717ull) >> 32) % limite;
+}
+
+static unsigned int falhas;
+
+//------------------------------------------------------------------------------
+// registra uma diferença entre o esperado e o obtido
+static void falha(unsigned int semente, const char *teste, const char *esperado, const char *obtido) {
+
+  if (falhas++ < MAXIMO_FALHAS_IMPRESSAS)
+    printf("semente %u, %s:\n  esperado %s\n  obtido   %s\n", semente, teste, esperado, obtido);
+}
+
+//------------------------------------------------------------------------------
+// gera o multigrafo da semente, com minimo_vertices a maximo_vertices vértices: árvores
+// com poucos atalhos (muitos vértices e arestas de corte), ciclos ligados por vértices
+// ou grafos esparsos quaisquer
+static void gera(grafo_gerado *gg, unsigned int semente, uint32_t minimo_vertices, uint32_t maximo_vertices) {
+  uint32_t n, m;
+
+  estado_aleatorio = 88172645463325252ull ^ ((uint64_t) semente * 0x9e3779b97f4a7c15ull);
+  n = minimo_vertices + aleatorio(maximo_vertices - minimo_vertices + 1);
+  m = aleatorio(2 * n + 1);
+
+  gg->num_vertices = n;
+  gg->num_arestas = m;
+  gg->u = malloc(sizeof(uint32_t) * (m ? m : 1));
+  gg->v = malloc(sizeof(uint32_t) * (m ? m : 1));
+  gg->w = malloc(sizeof(uint32_t) * (m ? m : 1));
+  if (!gg->u || !gg->v || !gg->w) {
+    fprintf(stderr, "verifica: erro em malloc\n");
+    exit(1);
+  }
+
+  uint32_t tipo = aleatorio(3);
+  uint32_t pesos = aleatorio(3);
+  gg->unitario = (pesos == 0);
+
+  for (uint32_t i = 0; i < m; i++) {
+    uint32_t u = aleatorio(n), v;
+
+    if (tipo == 0)
+      v = u ? aleatorio(u) : 0;
+    else if (tipo == 1)
+      v = (u + 1 + aleatorio(2)) % n;
+    else
+      v = aleatorio(n);
+
+    // atalhos raros nas árvores; o resto fica como veio (laços e repetições inclusive)
+    if ((tipo == 0) && (aleatorio(8) == 0))
+      v = aleatorio(n);
+
+    gg->u[i] = u;
+    gg->v[i] = v;
+    gg->w[i] = (pesos == 0) ? 1 : (pesos == 1) ? 1 + aleatorio(6) : 4000000000u + aleatorio(1000);
+  }
+}
+
+//------------------------------------------------------------------------------
+static void libera(grafo_gerado *gg) {
+
+  free(gg->u);
+  free(gg->v);
+  free(gg->w);
+}
+
+//------------------------------------------------------------------------------
+// escreve em f, no formato de le_grafo, todos os vértices (na ordem dos números)
+// e as primeiras num_arestas arestas de gg
+static void escreve(FILE *f, const grafo_gerado *gg, uint32_t num_arestas) {
+
+  fprintf(f, "aleatorio\n");
+  for (uint32_t i = 0; i < gg->num_vertices; i++)
+    fprintf(f, "%u\n", i);
+
+  for (uint32_t i = 0; i < num_arestas; i++)
+    fprintf(f, "%u -- %u %u\n", gg->u[i], gg->v[i], gg->w[i]);
+
+  rewind(f);
+}
+
+//------------------------------------------------------------------------------
+// arquivo temporário para os textos dos grafos, removido ao ser fechado
+static FILE *abre_temporario(void) {
+  FILE *f = tmpfile();
+
+  if (!f) {
+    fprintf(stderr, "verifica: erro em tmpfile\n");
+    exit(1);
+  }
+
+  return f;
+}
+
+//------------------------------------------------------------------------------
+// lê de um texto as primeiras num_arestas arestas de gg
+static grafo *le(const grafo_gerado *gg, uint32_t num_arestas) {
+  FILE *f = abre_temporario();
+
+  escreve(f, gg, num_arestas);
+  grafo *g = le_grafo(f);
+  fclose(f);
+
+  return g;
+}
+
+//------------------------------------------------------------------------------
+// lê um grafo sem vértices, com o mesmo nome dos gerados
+static grafo *le_vazio(void) {
+  FILE *f = abre_temporario();
+
+  fprintf(f, "aleatorio\n");
+  rewind(f);
+  grafo *g = le_grafo(f);
+  fclose(f);
+
+  return g;
+}
+
+//------------------------------------------------------------------------------
+// insere em g, por insere_aresta, as arestas de .. ate-1 de gg
+static void insere_arestas(grafo *g, const grafo_gerado *gg, uint32_t de, uint32_t ate) {
+  char nome_u[16], nome_v[16];
+
+  for (uint32_t i = de; i < ate; i++) {
+    snprintf(nome_u, sizeof(nome_u), "%u", gg->u[i]);
+    snprintf(nome_v, sizeof(nome_v), "%u", gg->v[i]);
+    insere_aresta(g, nome_u, nome_v, gg->w[i]);
+  }
+}
+
+//------------------------------------------------------------------------------
+// as respostas de teste.c numa única "string", alocada
+static char *respostas(grafo *g) {
+  char *d = diametros(g), *vc = vertices_corte(g), *ac = arestas_corte(g);
+  char *r = NULL;
+  size_t tamanho = 0;
+  FILE *f = open_memstream(&r, &tamanho);
+
+  if (!f || !d || !vc || !ac) {
+    fprintf(stderr, "verifica: erro ao montar as respostas\n");
+    exit(1);
+  }
+
+  fprintf(f, "%u vértices, %u arestas, %u componentes, %sbipartido, diâmetros [%s], "
+          "vértices de corte [%s], arestas de corte [%s]", n_vertices(g), n_arestas(g),
+          n_componentes(g), bipartido(g) ? "" : "não ", d, vc, ac);
+  fclose(f);
+
+  free(d);
+  free(vc);
+  free(ac);
+  return r;
+}
+
+//------------------------------------------------------------------------------
+// compara as respostas de g com as esperadas e destrói g
+static void confere(unsigned int semente, const char *teste, grafo *g, const char *esperado) {
+
+  if (!g) {
+    falha(semente, teste, esperado, "(grafo NULL)");
+    return;
+  }
+
+  char *obtido = respostas(g);
+  if (strcmp(esperado, obtido) != 0)
+    falha(semente, teste, esperado, obtido);
+
+  free(obtido);
+  if (!destroi_grafo(g))
+    falha(semente, teste, "destroi_grafo devolve 1", "0");
+}
+
+//------------------------------------------------------------------------------
+// insere_vertice e insere_aresta: num grafo vazio e num grafo lido com parte das arestas
+static void verifica_insercao(unsigned int semente, const grafo_gerado *gg, const char *esperado) {
+  char nome[16];
+
+  for (int parte = 0; parte < 2; parte++) {
+    uint32_t lidas = parte ? gg->num_arestas / 2 : 0;
+    grafo *g = parte ? le(gg, lidas) : le_vazio();
+
+    // no grafo vazio, os vértices entram um a um, na ordem do texto
+    if (!parte) {
+      for (uint32_t i = 0; i < gg->num_vertices; i++) {
+        snprintf(nome, sizeof(nome), "%u", i);
+        insere_vertice(g, nome);
+      }
+    }
+
+    insere_arestas(g, gg, lidas, gg->num_arestas);
+    confere(semente, parte ? "insere_aresta depois de le_grafo" : "insere_vertice e insere_aresta", g, esperado);
+  }
+}
+
+//------------------------------------------------------------------------------
+// reordena_vertices nas três ordens, com as consultas logo depois e depois de
+// inserir a outra metade das arestas; em ORDEM_LARGURA, a numeração com 4 threads
+// tem de ser a mesma que com 1
+static void verifica_reordenacao(unsigned int semente, const grafo_gerado *gg, const char *esperado) {
+  static const ordem_vertices ordens[] = { ORDEM_CUTHILL_MCKEE, ORDEM_LARGURA, ORDEM_GRAU };
+
+  for (unsigned int i = 0; i < sizeof(ordens) / sizeof(ordens[0]); i++) {
+    grafo *g = le(gg, gg->num_arestas);
+    if (!reordena_vertices(g, ordens[i]))
+      falha(semente, "reordena_vertices", "1", "0");
+    confere(semente, "reordena_vertices", g, esperado);
+
+    uint32_t lidas = gg->num_arestas / 2;
+    g = le(gg, lidas);
+    if (!reordena_vertices(g, ordens[i]))
+      falha(semente, "reordena_vertices", "1", "0");
+    insere_arestas(g, gg, lidas, gg->num_arestas);
+    confere(semente, "insere_aresta depois de reordena_vertices", g, esperado);
+  }
+
+  grafo *sequencial = le(gg, gg->num_arestas);
+  grafo *paralelo = le(gg, gg->num_arestas);
+  define_num_threads(paralelo, 4);
+  reordena_vertices(sequencial, ORDEM_LARGURA);
+  reordena_vertices(paralelo, ORDEM_LARGURA);
+  for (uint32_t v = 0; v < gg->num_vertices; v++) {
+    if (strcmp(nome_vertice(sequencial, v), nome_vertice(paralelo, v)) != 0) {
+      falha(semente, "ORDEM_LARGURA com 4 threads", nome_vertice(sequencial, v), nome_vertice(paralelo, v));
+      break;
+    }
+  }
+  destroi_grafo(sequencial);
+  destroi_grafo(paralelo);
+}
+
+//------------------------------------------------------------------------------
+// cortes mantidos por insere_aresta: uma consulta de cortes logo depois da primeira
+// inserção liga os blocos incrementais, e as inserções seguintes são conferidas em
+// alguns pontos contra le_grafo do mesmo prefixo das arestas
+static void verifica_cortes_incrementais(unsigned int semente, const grafo_gerado *gg) {
+  uint32_t lidas = gg->num_arestas / 2;
+  grafo *g = le(gg, lidas);
+
+  for (uint32_t i = lidas; i < gg->num_arestas; i++) {
+    insere_arestas(g, gg, i, i + 1);
+
+    uint32_t inseridas = i + 1 - lidas;
+    if ((inseridas == 1) || (i + 1 == gg->num_arestas) || (inseridas % (gg->num_arestas / 8 + 1) == 0)) {
+      grafo *prefixo = le(gg, i + 1);
+      char *esperado = respostas(prefixo), *obtido = respostas(g);
+
+      if (strcmp(esperado, obtido) != 0)
+        falha(semente, "cortes depois de insere_aresta", esperado, obtido);
+
+      free(esperado);
+      free(obtido);
+      destroi_grafo(prefixo);
+    }
+  }
+
+  destroi_grafo(g);
+}
+
+//------------------------------------------------------------------------------
+// grafo_builder_cria, builder_adiciona_arestas e builder_finaliza, com as arestas
+// em um ou mais lotes e estimativas certas, curtas ou longas; com
+// builder_define_num_vertices, o grafo é o de le_grafo, e sem ele, o de le_grafo
+// sem os vértices isolados depois do maior identificador usado numa aresta
+static void verifica_builder(unsigned int semente, const grafo_gerado *gg, const char *esperado) {
+  grafo_gerado sem_isolados = *gg;
+
+  sem_isolados.num_vertices = 0;
+  for (uint32_t i = 0; i < gg->num_arestas; i++) {
+    if (gg->u[i] >= sem_isolados.num_vertices)
+      sem_isolados.num_vertices = gg->u[i] + 1;
+    if (gg->v[i] >= sem_isolados.num_vertices)
+      sem_isolados.num_vertices = gg->v[i] + 1;
+  }
+  grafo *g = le(&sem_isolados, sem_isolados.num_arestas);
+  char *esperado_sem_isolados = respostas(g);
+  destroi_grafo(g);
+
+  for (uint32_t lotes = 1; lotes <= 4; lotes++) {
+    size_t estimativa_vertices = (lotes == 4) ? 4 * (size_t) gg->num_vertices + 16 : gg->num_vertices;
+    size_t estimativa_arestas = (lotes == 1) ? gg->num_arestas : gg->num_arestas / 2;
+    grafo_builder *b = grafo_builder_cria("aleatorio", estimativa_vertices, estimativa_arestas);
+
+    if ((lotes % 2 == 1) && !builder_define_num_vertices(b, gg->num_vertices))
+      falha(semente, "builder_define_num_vertices", "1", "0");
+
+    for (uint32_t i = 0; i < lotes; i++) {
+      uint32_t inicio = (uint32_t) ((uint64_t) gg->num_arestas * i / lotes);
+      uint32_t fim = (uint32_t) ((uint64_t) gg->num_arestas * (i + 1) / lotes);
+      const uint32_t *w = gg->unitario ? NULL : gg->w + inicio;
+
+      if (!builder_adiciona_arestas(b, gg->u + inicio, gg->v + inicio, w, fim - inicio))
+        falha(semente, "builder_adiciona_arestas", "1", "0");
+    }
+
+    confere(semente, (lotes % 2 == 1) ? "builder_finaliza" : "builder_finaliza sem builder_define_num_vertices",
+            builder_finaliza(b), (lotes % 2 == 1) ? esperado : esperado_sem_isolados);
+  }
+
+  free(esperado_sem_isolados);
+}
+
+//------------------------------------------------------------------------------
+// le_grafo_paralelo com 1 a 4 threads
+static void verifica_leitura_paralela(unsigned int semente, const grafo_gerado *gg, const char *esperado) {
+  FILE *f = abre_temporario();
+
+  escreve(f, gg, gg->num_arestas);
+
+  for (unsigned int num_threads = 1; num_threads <= 4; num_threads++) {
+    rewind(f);
+    confere(semente, "le_grafo_paralelo", le_grafo_paralelo(f, num_threads), esperado);
+  }
+
+  fclose(f);
+}
+
+//------------------------------------------------------------------------------
+// define_modo_diametro(DIAMETRO_EXAUSTIVO) com 1 e 3 threads, contra os limitantes de
+// le_grafo; com pesos unitários, a busca exaustiva é a de várias origens por vez
+static void verifica_exaustivo(unsigned int semente, const grafo_gerado *gg, const char *esperado) {
+
+  if (gg->num_vertices > MAXIMO_VERTICES_EXAUSTIVO)
+    return;
+
+  for (unsigned int num_threads = 1; num_threads <= 3; num_threads += 2) {
+    grafo *g = le(gg, gg->num_arestas);
+    define_modo_diametro(g, DIAMETRO_EXAUSTIVO);
+    define_num_threads(g, num_threads);
+    confere(semente, "DIAMETRO_EXAUSTIVO", g, esperado);
+  }
+}
+
+//------------------------------------------------------------------------------
+// define_num_threads com 2 e 4 threads; nos grafos grandes, as componentes, os
+// cortes e os diâmetros são calculados em paralelo
+static void verifica_threads(unsigned int semente, const grafo_gerado *gg, const char *esperado) {
+
+  for (unsigned int num_threads = 2; num_threads <= 4; num_threads += 2) {
+    grafo *g = le(gg, gg->num_arestas);
+    define_num_threads(g, num_threads);
+    confere(semente, "define_num_threads", g, esperado);
+  }
+}
+
+//------------------------------------------------------------------------------
+// rotula em componente as componentes do grafo de adjacência adj (n x n) sem o
+// vértice removido (UINT32_MAX para não remover nenhum); removido fica com UINT32_MAX
+static void rotula_sem(const unsigned char *adj, uint32_t n, uint32_t removido, uint32_t *componente, uint32_t *pilha) {
+
+  for (uint32_t x = 0; x < n; x++)
+    componente[x] = UINT32_MAX;
+
+  for (uint32_t raiz = 0; raiz < n; raiz++) {
+    if ((raiz == removido) || (componente[raiz] != UINT32_MAX))
+      continue;
+
+    uint32_t topo = 0;
+    componente[raiz] = raiz;
+    pilha[topo++] = raiz;
+    while (topo > 0) {
+      uint32_t x = pilha[--topo];
+      for (uint32_t y = 0; y < n; y++) {
+        if (adj[(size_t) x * n + y] && (y != removido) && (componente[y] == UINT32_MAX)) {
+          componente[y] = raiz;
+          pilha[topo++] = y;
+        }
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// eh_vertice_corte e eh_ponte contra vertices_corte_em e arestas_corte_em, e bloco_de
+// contra a força bruta: dois vértices que não são de corte estão no mesmo bloco se e
+// só se nenhum outro vértice os separa; os vértices de corte ficam com nós próprios,
+// depois dos blocos, na ordem de vertices_corte (só nos grafos pequenos, em que a
+// matriz de adjacência e as n buscas cabem)
+static void verifica_consultas_cortes(unsigned int semente, const grafo_gerado *gg) {
+  uint32_t n = gg->num_vertices;
+
+  if (n > MAXIMO_VERTICES_FORCA_BRUTA)
+    return;
+
+  grafo *g = le(gg, gg->num_arestas);
+  char nome_u[16], nome_v[16], esperado[64], obtido[64];
+  unsigned int total_vc, total_ac;
+
+  vertices_corte_em(g, NULL, 0, &total_vc);
+  arestas_corte_em(g, NULL, 0, &total_ac);
+
+  unsigned int *vc = malloc(sizeof(unsigned int) * (total_vc + 1));
+  unsigned int *ac = malloc(sizeof(unsigned int) * (2 * (size_t) total_ac + 1));
+  unsigned char *adj = calloc((size_t) n * n + 1, 1);
+  unsigned char *ponte = calloc((size_t) n * n + 1, 1);
+  unsigned int *posto_corte = malloc(sizeof(unsigned int) * (n + 1));
+  unsigned int *no = malloc(sizeof(unsigned int) * (n + 1));
+  uint32_t *componentes = malloc(sizeof(uint32_t) * ((size_t) n + 1) * (n + 1));
+  uint32_t *pilha = malloc(sizeof(uint32_t) * (n + 1));
+  if (!vc || !ac || !adj || !ponte || !posto_corte || !no || !componentes || !pilha) {
+    fprintf(stderr, "verifica: erro em malloc\n");
+    exit(1);
+  }
+
+  // os identificadores de g viram os números dos nomes, os do grafo gerado
+  vertices_corte_em(g, vc, total_vc, &total_vc);
+  arestas_corte_em(g, ac, total_ac, &total_ac);
+  for (uint32_t x = 0; x < n; x++)
+    posto_corte[x] = UINT_MAX;
+  for (unsigned int i = 0; i < total_vc; i++)
+    posto_corte[atoi(nome_vertice(g, vc[i]))] = i;
+  for (unsigned int i = 0; i < total_ac; i++) {
+    uint32_t x = (uint32_t) atoi(nome_vertice(g, ac[2 * i]));
+    uint32_t y = (uint32_t) atoi(nome_vertice(g, ac[2 * i + 1]));
+    ponte[(size_t) x * n + y] = ponte[(size_t) y * n + x] = 1;
+  }
+  for (uint32_t i = 0; i < gg->num_arestas; i++)
+    adj[(size_t) gg->u[i] * n + gg->v[i]] = adj[(size_t) gg->v[i] * n + gg->u[i]] = 1;
+
+  for (uint32_t x = 0; x < n; x++) {
+    snprintf(nome_u, sizeof(nome_u), "%u", x);
+    if (eh_vertice_corte(g, nome_u) != (posto_corte[x] != UINT_MAX)) {
+      snprintf(esperado, sizeof(esperado), "eh_vertice_corte(%u) = %u", x, posto_corte[x] != UINT_MAX);
+      falha(semente, "eh_vertice_corte", esperado, "o contrário");
+    }
+    no[x] = bloco_de(g, nome_u);
+  }
+
+  // eh_ponte nas duas ordens de cada aresta, que é ponte só se aparece em arestas_corte
+  for (uint32_t i = 0; i < gg->num_arestas; i++) {
+    uint32_t x = gg->u[i], y = gg->v[i];
+
+    snprintf(nome_u, sizeof(nome_u), "%u", x);
+    snprintf(nome_v, sizeof(nome_v), "%u", y);
+    if ((eh_ponte(g, nome_u, nome_v) != ponte[(size_t) x * n + y]) ||
+        (eh_ponte(g, nome_v, nome_u) != ponte[(size_t) x * n + y])) {
+      snprintf(esperado, sizeof(esperado), "eh_ponte(%u, %u) = %u", x, y, ponte[(size_t) x * n + y]);
+      falha(semente, "eh_ponte", esperado, "o contrário");
+    }
+  }
+
+  rotula_sem(adj, n, UINT32_MAX, componentes + (size_t) n * n, pilha);
+  for (uint32_t z = 0; z < n; z++)
+    rotula_sem(adj, n, z, componentes + (size_t) z * n, pilha);
+
+  for (uint32_t x = 0; x < n; x++) {
+    if (posto_corte[x] != UINT_MAX)
+      continue;
+
+    for (uint32_t y = x + 1; y < n; y++) {
+      if (posto_corte[y] != UINT_MAX)
+        continue;
+
+      unsigned int junto = (componentes[(size_t) n * n + x] == componentes[(size_t) n * n + y]);
+      for (uint32_t z = 0; junto && (z < n); z++) {
+        if ((z != x) && (z != y) && (componentes[(size_t) z * n + x] != componentes[(size_t) z * n + y]))
+          junto = 0;
+      }
+
+      if ((no[x] == no[y]) != junto) {
+        snprintf(esperado, sizeof(esperado), "%u e %u %sno mesmo bloco", x, y, junto ? "" : "não ");
+        snprintf(obtido, sizeof(obtido), "bloco_de %u e %u", no[x], no[y]);
+        falha(semente, "bloco_de", esperado, obtido);
+      }
+    }
+  }
+
+  // os vértices de corte vêm depois de todos os blocos, em nós seguidos na ordem de
+  // vertices_corte (um bloco pode ter só vértices de corte, então b não sai de no)
+  unsigned int primeiro_corte = total_vc ? no[atoi(nome_vertice(g, vc[0]))] : UINT_MAX;
+  for (uint32_t x = 0; x < n; x++) {
+    unsigned int certo = (posto_corte[x] != UINT_MAX) ? (no[x] == primeiro_corte + posto_corte[x]) : (no[x] < primeiro_corte);
+
+    if (!certo) {
+      snprintf(esperado, sizeof(esperado), "bloco_de(%u) %s %u", x, (posto_corte[x] != UINT_MAX) ? "=" : "<",
+               (posto_corte[x] != UINT_MAX) ? primeiro_corte + posto_corte[x] : primeiro_corte);
+      snprintf(obtido, sizeof(obtido), "%u", no[x]);
+      falha(semente, "bloco_de", esperado, obtido);
+    }
+  }
+
+  free(vc);
+  free(ac);
+  free(adj);
+  free(ponte);
+  free(posto_corte);
+  free(no);
+  free(componentes);
+  free(pilha);
+  destroi_grafo(g);
+}
+
+//------------------------------------------------------------------------------
+// junta os nomes dos vértices ids[0 .. n-1] separados por espaços, como em vertices_corte
+static char *junta_nomes(grafo *g, const unsigned int *ids, unsigned int n) {
+  char *r = NULL;
+  size_t tamanho = 0;
+  FILE *f = open_memstream(&r, &tamanho);
+
+  for (unsigned int i = 0; i < n; i++) {
+    const char *nome_v = nome_vertice(g, ids[i]);
+    fprintf(f, "%s%s", i ? " " : "", nome_v ? nome_v : "(NULL)");
+  }
+  fclose(f);
+
+  return r;
+}
+
+//------------------------------------------------------------------------------
+// diametros_em, vertices_corte_em e arestas_corte_em: o tamanho informado com
+// capacidade 0, o resultado completo comparado com a versão em "string" e, com um
+// resultado a menos de capacidade, o prefixo sem escrita além da capacidade
+static void verifica_em(unsigned int semente, const grafo_gerado *gg) {
+  grafo *g = le(gg, gg->num_arestas);
+  char *d = diametros(g), *vc = vertices_corte(g), *ac = arestas_corte(g);
+  unsigned int total_d, total_vc, total_ac;
+
+  if (!diametros_em(g, NULL, 0, &total_d) || !vertices_corte_em(g, NULL, 0, &total_vc) ||
+      !arestas_corte_em(g, NULL, 0, &total_ac)) {
+    falha(semente, "*_em com capacidade 0", "1", "0");
+    total_d = total_vc = total_ac = 0;
+  }
+
+  // uma posição a mais em cada vetor, marcada, para flagrar escrita além da capacidade
+  uint64_t *diam = malloc(sizeof(uint64_t) * (total_d + 1));
+  unsigned int *ids = malloc(sizeof(unsigned int) * (2 * (size_t) (total_vc + total_ac) + 1));
+  char *r = NULL;
+  size_t tamanho = 0;
+  unsigned int total;
+
+  FILE *f = open_memstream(&r, &tamanho);
+  diametros_em(g, diam, total_d, &total);
+  for (unsigned int i = 0; i < total_d; i++)
+    fprintf(f, "%s%" PRIu64, i ? " " : "", diam[i]);
+  fclose(f);
+  if ((total != total_d) || (strcmp(r, d) != 0))
+    falha(semente, "diametros_em", d, r);
+  free(r);
+
+  if (total_d > 0) {
+    diam[total_d - 1] = UINT64_MAX;
+    diametros_em(g, diam, total_d - 1, &total);
+    if ((total != total_d) || (diam[total_d - 1] != UINT64_MAX))
+      falha(semente, "diametros_em com capacidade menor", "sem escrita além da capacidade", "escreveu");
+  }
+
+  vertices_corte_em(g, ids, total_vc, &total);
+  r = junta_nomes(g, ids, total_vc);
+  if ((total != total_vc) || (strcmp(r, vc) != 0))
+    falha(semente, "vertices_corte_em", vc, r);
+  free(r);
+
+  if (total_vc > 0) {
+    ids[total_vc - 1] = UINT_MAX;
+    vertices_corte_em(g, ids, total_vc - 1, &total);
+    if ((total != total_vc) || (ids[total_vc - 1] != UINT_MAX))
+      falha(semente, "vertices_corte_em com capacidade menor", "sem escrita além da capacidade", "escreveu");
+  }
+
+  arestas_corte_em(g, ids, total_ac, &total);
+  r = junta_nomes(g, ids, 2 * total_ac);
+  if ((total != total_ac) || (strcmp(r, ac) != 0))
+    falha(semente, "arestas_corte_em", ac, r);
+  free(r);
+
+  if (total_ac > 0) {
+    ids[2 * total_ac - 2] = UINT_MAX;
+    arestas_corte_em(g, ids, total_ac - 1, &total);
+    if ((total != total_ac) || (ids[2 * total_ac - 2] != UINT_MAX))
+      falha(semente, "arestas_corte_em com capacidade menor", "sem escrita além da capacidade", "escreveu");
+  }
+
+  free(diam);
+  free(ids);
+  free(d);
+  free(vc);
+  free(ac);
+  destroi_grafo(g);
+}
+
+//------------------------------------------------------------------------------
+// caminho da imagem binária temporária de verifica_binario, criada por mkstemp
+static char imagem[] = "/tmp/verifica.grafo.XXXXXX";
+
+static void remove_imagem(void) {
+
+  unlink(imagem);
+}
+
+//------------------------------------------------------------------------------
+// reescreve a imagem com os primeiros tamanho bytes de bytes
+static void regrava_imagem(const unsigned char *bytes, size_t tamanho) {
+  FILE *f = fopen(imagem, "wb");
+
+  if (!f || (fwrite(bytes, 1, tamanho, f) != tamanho) || fclose(f)) {
+    fprintf(stderr, "verifica: erro ao escrever %s\n", imagem);
+    exit(1);
+  }
+}
+
+//------------------------------------------------------------------------------
+// confere que carrega_grafo_binario recusa a imagem com cada bit trocado e com
+// cada tamanho menor que o original; só para imagens de até
+// MAXIMO_BYTES_CORROMPIDOS bytes, de um grafo em cada 10, para não demorar
+static void verifica_corrupcao(unsigned int semente) {
+  unsigned char bytes[MAXIMO_BYTES_CORROMPIDOS];
+  char obtido[64];
+  size_t tamanho;
+  FILE *f = fopen(imagem, "rb");
+  grafo *g;
+
+  if (!f) {
+    fprintf(stderr, "verifica: erro ao abrir %s\n", imagem);
+    exit(1);
+  }
+  tamanho = fread(bytes, 1, sizeof(bytes), f);
+  if (fgetc(f) != EOF) {
+    fclose(f);
+    return;
+  }
+  fclose(f);
+
+  for (size_t i = 0; i < 8 * tamanho; i++) {
+    bytes[i / 8] ^= (unsigned char) (1u << (i % 8));
+    regrava_imagem(bytes, tamanho);
+    bytes[i / 8] ^= (unsigned char) (1u << (i % 8));
+
+    if ((g = carrega_grafo_binario(imagem)) != NULL) {
+      snprintf(obtido, sizeof(obtido), "aceita com o bit %zu trocado", i);
+      falha(semente, "carrega_grafo_binario de imagem corrompida", "NULL", obtido);
+      destroi_grafo(g);
+    }
+  }
+
+  for (size_t t = 0; t < tamanho; t++) {
+    regrava_imagem(bytes, t);
+
+    if ((g = carrega_grafo_binario(imagem)) != NULL) {
+      snprintf(obtido, sizeof(obtido), "aceita com %zu de %zu bytes", t, tamanho);
+      falha(semente, "carrega_grafo_binario de imagem truncada", "NULL", obtido);
+      destroi_grafo(g);
+    }
+  }
+
+  regrava_imagem(bytes, tamanho);
+}
+
+//------------------------------------------------------------------------------
+// salva_grafo_binario e carrega_grafo_binario, de um grafo lido e de um construído
+// por inserções
+static void verifica_binario(unsigned int semente, const grafo_gerado *gg, const char *esperado) {
+
+  for (int inserido = 0; inserido < 2; inserido++) {
+    grafo *g = le(gg, inserido ? gg->num_arestas / 2 : gg->num_arestas);
+
+    if (inserido)
+      insere_arestas(g, gg, gg->num_arestas / 2, gg->num_arestas);
+
+    if (!salva_grafo_binario(g, imagem))
+      falha(semente, "salva_grafo_binario", "1", "0");
+    destroi_grafo(g);
+
+    if (!inserido && (semente % 10 == 0))
+      verifica_corrupcao(semente);
+
+    confere(semente, inserido ? "carrega_grafo_binario depois de inserções" : "carrega_grafo_binario",
+            carrega_grafo_binario(imagem), esperado);
+  }
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+  unsigned int num_grafos = (argc > 1) ? (unsigned int) strtoul(argv[1], NULL, 10) : 300;
+  int fd = mkstemp(imagem);
+
+  if (fd < 0) {
+    fprintf(stderr, "verifica: erro ao criar %s\n", imagem);
+    return 1;
+  }
+  close(fd);
+  atexit(remove_imagem);
+
+  for (unsigned int semente = 0; semente < num_grafos; semente++) {
+    grafo_gerado gg;
+
+    // um grafo em cada 100 é grande o bastante para as versões paralelas (leitura em
+    // vários pedaços, componentes e cortes em paralelo)
+    // e um em cada 20 tem centenas de vértices, para a busca exaustiva em vários lotes
+    if (semente % 100 == 99)
+      gera(&gg, semente, 20000, 40000);
+    else if (semente % 20 == 19)
+      gera(&gg, semente, 300, 1500);
+    else
+      gera(&gg, semente, 1, 120);
+    grafo *g = le(&gg, gg.num_arestas);
+    char *esperado = respostas(g);
+    destroi_grafo(g);
+
+    verifica_insercao(semente, &gg, esperado);
+    verifica_binario(semente, &gg, esperado);
+    verifica_cortes_incrementais(semente, &gg);
+    verifica_reordenacao(semente, &gg, esperado);
+    verifica_builder(semente, &gg, esperado);
+    verifica_leitura_paralela(semente, &gg, esperado);
+    verifica_threads(semente, &gg, esperado);
+    verifica_exaustivo(semente, &gg, esperado);
+    verifica_em(semente, &gg);
+    verifica_consultas_cortes(semente, &gg);
+
+    free(esperado);
+    libera(&gg);
+  }
+
+  printf("verifica: %u grafos, %u diferenças\n", num_grafos, falhas);
+  return falhas != 0;
+}